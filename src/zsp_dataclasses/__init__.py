@@ -6,4 +6,7 @@ from .claims_refs import *
 from .shared_stmts import *
 from .types import *
 from .core_lib import *
+from .backends import *
+from .profiling import *
+from .farm import *
 from vsc_dataclasses.expr import *
\ No newline at end of file
@@ -13,6 +13,9 @@ from .impl.activity_sequence_impl import ActivitySequenceImpl
 
 from .impl.activity_block_meta_t import ActivityBlockMetaT
 from .impl.do_impl_meta import DoImplMeta
+from .impl.debug import Debug
+
+_dbg = Debug.get("activity")
 
 class bind(ActivityBindImpl):
     pass
@@ -31,7 +34,8 @@ class schedule(metaclass=ActivityBlockMetaT):
         pass
     
     def __enter__(self):
-        print("sequence.__enter__")
+        if _dbg.en:
+            _dbg.debug("sequence.__enter__")
         
     def __exit__(self, t, v, tb):
         pass
@@ -42,7 +46,8 @@ class match(object):
         pass
     
     def __enter__(self):
-        print("sequence.__enter__")
+        if _dbg.en:
+            _dbg.debug("sequence.__enter__")
         
     def __exit__(self, t, v, tb):
         pass
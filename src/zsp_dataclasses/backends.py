@@ -0,0 +1,38 @@
+#****************************************************************************
+#* backends.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+from .impl.backend import Backend
+from .impl.backend_asyncio import BackendAsyncio
+from .impl.backend_batched import BackendBatched
+from .impl.backend_processpool import BackendProcessPool
+from .impl.backend_threadpool import BackendThreadPool
+from .impl.backend_work_stealing import BackendWorkStealing
+from .impl.rt_ctxt import RtCtxt
+
+async def offload(fn, *args):
+    """Runs a blocking or CPU-bound callable from an exec body using the
+    backend of the scenario being evaluated"""
+    backend = RtCtxt.inst().backend
+    if backend is None:
+        return fn(*args)
+    else:
+        return await backend.offload(fn, *args)
+
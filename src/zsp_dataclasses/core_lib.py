@@ -19,16 +19,24 @@
 #*     Author: 
 #*
 #****************************************************************************
-import sys
+from .impl.debug import Debug
 from .impl.reg_c_meta import RegCMeta
 from .impl.reg_group_meta import RegGroupMeta
 from .impl.reg_group_decorator_impl import RegGroupDecoratorImpl
 
+_dbg = Debug.get("fn")
+
+_print = None
+
 def print(*args):
     from .impl.ctor import Ctor
+    global _print
+    if _print is None:
+        _print = Ctor.sym("std_pkg::print")
     ctor = Ctor.inst()
-    print_f = ctor.ctxt().findDataTypeFunction("std_pkg::print")
-    sys.stdout.write("print_f: %s\n" % str(print_f))
+    print_f = ctor.core_fn(_print)
+    if _dbg.en:
+        _dbg.debug("print_f: %s" % str(print_f))
 
     ctor.proc_scope().addStatement(
         ctor.ctxt().mkTypeProcStmtExpr(
@@ -27,6 +27,9 @@ from .method_proxy_fn import MethodProxyFn
 from .typeinfo_action import TypeInfoAction
 from .typeinfo_flow_obj_ref import TypeInfoFlowObjRef
 from .typeinfo_claim import TypeInfoClaim
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 class ActionDecoratorImpl(BaseDecoratorImpl):
 
@@ -34,7 +37,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
         return TypeKindE.Action
 
     def pre_decorate(self, T):
-        print("Action.pre_decorate")
+        if _dbg.en:
+            _dbg.debug("Action.pre_decorate")
         action_ti : TypeInfoAction = TypeInfoAction.get(self.get_typeinfo())
         ctor_a = Ctor.inst()
 
@@ -52,7 +56,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
         ctor_a = Ctor.inst()
         # TODO: we must recognize claims, refs, and actions
 
-        print("value: %s" % str(value))
+        if _dbg.en:
+            _dbg.debug("value: %s" % str(value))
         ti = typeworks.TypeInfo.get(value)
 
 #        if callable(value):
@@ -62,7 +67,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
 #            print("Not callable")
 
         if issubclass(value, (InputOutputT,LockShareT)):
-            print("Ref or Claim")
+            if _dbg.en:
+                _dbg.debug("Ref or Claim")
             obj_t_ti = typeworks.TypeInfo.get(value.T, False)
             if obj_t_ti is None:
                 raise Exception("Type %s is not registered" % str(value.T))
@@ -87,12 +93,15 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
             action_ti.addField(field_ti, field_obj)
             self.set_field_initial(key, None)
         elif ti is not None:
-            print("ti is not None")
+            if _dbg.en:
+                _dbg.debug("ti is not None")
             ti_a = TypeInfo.get(ti, True)
-            print("ti_a=%s" % str(ti_a))
+            if _dbg.en:
+                _dbg.debug("ti_a=%s" % str(ti_a))
             if ti_a is not None:
                 if isinstance(ti_a, TypeInfoAction):
-                    print("Action: lib_typeobj=%s" % str(ti_a.lib_typeobj))
+                    if _dbg.en:
+                        _dbg.debug("Action: lib_typeobj=%s" % str(ti_a.lib_typeobj))
                     field_obj = ctor_a.ctxt().mkTypeFieldPhy(
                             key,
                             ti_a.lib_typeobj,
@@ -118,7 +127,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
         ActionImpl.addMethods(Tp)
 
     def pre_register(self):
-        print("Action.pre_register")
+        if _dbg.en:
+            _dbg.debug("Action.pre_register")
         action_ti = TypeInfoAction.get(self.get_typeinfo())
         funcs = typeworks.DeclRgy.pop_decl(
             MethodProxyFn,
@@ -126,7 +136,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
         )
 
         # TODO: add function declarations to type
-        print("Action: funcs=%s" % str(funcs))
+        if _dbg.en:
+            _dbg.debug("Action: funcs=%s" % str(funcs))
 
         # TODO: add execs to 
 
@@ -149,7 +160,8 @@ class ActionDecoratorImpl(BaseDecoratorImpl):
    
     def _getLibDataType(self, name):
         ctor = Ctor.inst()
-        print("Action name: %s" % name)
+        if _dbg.en:
+            _dbg.debug("Action name: %s" % name)
         ds_t = ctor.ctxt().findDataTypeAction(name)
         if ds_t is None:
             ds_t = ctor.ctxt().mkDataTypeAction(name)
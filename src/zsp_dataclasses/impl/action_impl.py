@@ -12,6 +12,9 @@ from .activity_traverse_closure import ActivityTraverseClosure
 from .ctor import Ctor
 from .impl_base import ImplBase
 from .activity_traverse_closure import ActivityTraverseClosure
+from .debug import Debug
+
+_dbg = Debug.get("action")
 
 class ActionImpl(ImplBase):
     
@@ -89,16 +92,19 @@ class ActionImpl(ImplBase):
 
     @staticmethod
     def __init__(self, *args, **kwargs):
-        print("--> __init__")
+        if _dbg.en:
+            _dbg.debug("--> __init__")
         action_ti = TypeInfoAction.get(typeworks.TypeInfo.get(type(self)))
         action_ti.init(self, args, kwargs)
-        print("<-- __init__")
+        if _dbg.en:
+            _dbg.debug("<-- __init__")
 
     @staticmethod
     def __call__(self, *args, **kwargs):
         action_ti = TypeInfoAction.get(typeworks.TypeInfo.get(type(self)))
         ctor_a = Ctor.inst()
-        print("ActionImpl.__call__")
+        if _dbg.en:
+            _dbg.debug("ActionImpl.__call__")
 
         if len(args) > 0:
             raise Exception("Only kwargs can be passed to action traversal")
@@ -160,7 +166,8 @@ class ActionImpl(ImplBase):
 
         s = ctor.scope()
 
-        print("createHook: %s %s" % (str(hndl), str(s)))
+        if _dbg.en:
+            _dbg.debug("createHook: %s %s" % (str(hndl), str(s)))
 
         if s is None:
             # Push a scope with the backend object
@@ -168,7 +175,8 @@ class ActionImpl(ImplBase):
             # pop this scope on exit
             ctor.push_scope(None, hndl, False)
             inst = cls()
-            print("createHook: id=%x" % id(inst), flush=True)
+            if _dbg.en:
+                _dbg.debug("createHook: id=%x" % id(inst))
             hndl.setFieldData(inst)
         
     @staticmethod
@@ -197,11 +205,14 @@ class ActionImpl(ImplBase):
 
         comp = None
         if ctor.is_type_mode():
-            print("NOTE: createCompField in type mode")
+            if _dbg.en:
+                _dbg.debug("NOTE: createCompField in type mode")
             comp = ctor.scope(-2).facade_obj
-            print("  scope_s: %d" % len(ctor._scope_s))
+            if _dbg.en:
+                _dbg.debug("  scope_s: %d" % len(ctor._scope_s))
         else:
-            print("NOTE: createCompField in non-type mode", flush=True)
+            if _dbg.en:
+                _dbg.debug("NOTE: createCompField in non-type mode")
             comp = vsc_impl.FieldRefImpl(name, idx)
 
         # We will need a full elaboration of the component,
@@ -3,6 +3,9 @@ Created on Mar 19, 2022
 
 @author: mballance
 '''
+from .debug import Debug
+
+_dbg = Debug.get("activity")
 
 class ActivityBlockMetaT(type):
     
@@ -11,7 +14,8 @@ class ActivityBlockMetaT(type):
 
     def __enter__(self):
         # Create a specific
-        print("ActivityBlockMetaT.__enter__")
+        if _dbg.en:
+            _dbg.debug("ActivityBlockMetaT.__enter__")
         
     def __exit__(self, t, v, tb):
         pass    
@@ -23,6 +23,9 @@
 import vsc_dataclasses.impl as vsc_impl
 from .ctor import Ctor
 from .modelinfo_activity import ModelinfoActivity
+from .debug import Debug
+
+_dbg = Debug.get("activity")
 
 class ActivityReplicateImpl(object):
 
@@ -33,7 +36,8 @@ class ActivityReplicateImpl(object):
         ctor.pop_expr(self._count)
 
     def __enter__(self):
-        print("Replicate.__enter__")
+        if _dbg.en:
+            _dbg.debug("Replicate.__enter__")
         ctor_a = Ctor.inst()
         scope_dt = ctor_a.ctxt().mkDataTypeActivityReplicate(self._count.model)
         scope_ft = ctor_a.ctxt().mkTypeFieldActivity(
@@ -46,7 +50,8 @@ class ActivityReplicateImpl(object):
         ctor_a.push_activity_scope_mi(scope_mi)
 
     def __exit__(self, t, v, tb):
-        print("Replicate.__exit__")
+        if _dbg.en:
+            _dbg.debug("Replicate.__exit__")
         ctor_a = Ctor.inst()
         ctor_a.pop_activity_scope_mi()
 
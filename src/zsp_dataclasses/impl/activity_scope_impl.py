@@ -1,3 +1,6 @@
+from .debug import Debug
+
+_dbg = Debug.get("activity")
 
 class ActivityScopeImpl(object):
 
@@ -6,7 +9,8 @@ class ActivityScopeImpl(object):
             raise Exception("scope does not support positional arguments")
         
         if "label" in kwargs.keys():
-            print("Labeled scope")
+            if _dbg.en:
+                _dbg.debug("Labeled scope")
             self.name = kwargs["label"]
         else:
             self.name = None
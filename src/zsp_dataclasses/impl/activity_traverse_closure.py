@@ -4,6 +4,10 @@ Created on Jun 15, 2022
 @author: mballance
 '''
 import vsc_dataclasses.impl as vsc_impl
+from .debug import Debug
+from .with_c_precompiler import WithCPrecompiler
+
+_dbg = Debug.get("activity")
 
 
 class ActivityTraverseClosure(object):
@@ -11,32 +15,49 @@ class ActivityTraverseClosure(object):
     def __init__(self, traverse_t, field):
         self.traverse_t = traverse_t
         self.field = field
+        # WithCPlan of the with-clause, once the with block exits
+        self.plan = None
+        self._with_c = None
         pass
     
     def __call__(self, *args, **kwargs):
         if len(args) > 0:
             # TODO: it's okay if we're traversing an activity lambda
             raise Exception("Can only pass kwargs to an action traversal")
-        print("__call__: %s %s" % (str(args), str(kwargs)))
+        if _dbg.en:
+            _dbg.debug("__call__: %s %s" % (str(args), str(kwargs)))
         return self
         pass
     
     def __enter__(self):
-        print("enter")
+        if _dbg.en:
+            _dbg.debug("enter")
         ctor = vsc_impl.Ctor.inst()
         ctor.push_expr_mode()
         c = ctor.ctxt().mkTypeConstraintScope()
         self.traverse_t.setWithC(c)
+        self._with_c = c
         
         ctor.push_constraint_scope(c)
 
         # Return a Python action-field instance to support
         # constraints in a 'with' block
-        print("__enter__: return field=%s" % str(self.field))
+        if _dbg.en:
+            _dbg.debug("__enter__: return field=%s" % str(self.field))
         return self.field
     
     def __exit__(self, exc_type, exc_val, exc_tb):
+        from .ctor import Ctor
         ctor = vsc_impl.Ctor.inst()
+
+        if Ctor.inst().precompile_with and exc_type is None:
+            # Terms are filtered before they become constraints. Those that
+            # are dropped never reach the solver
+            expr_l = ctor.pop_exprs()
+            self.plan = WithCPrecompiler().precompile([e.model for e in expr_l])
+            for i in self.plan.keep_l:
+                self._with_c.addConstraint(
+                    ctor.ctxt().mkTypeConstraintExpr(expr_l[i].model))
         
         c = ctor.pop_constraint_scope()
         ctor.pop_expr_mode()
@@ -1,8 +1,28 @@
 
 class Backend(object):
+    """Schedules the branches of parallel activities. fork() receives the
+    coroutine that evaluates one branch, and returns a handle that is
+    later passed to join()"""
 
     def fork(self, coro):
         raise NotImplementedError("fork for class %s" % str(type(self)))
 
     async def join(self, task):
         raise NotImplementedError("join for class %s" % str(type(self)))
+
+    async def join_all(self, tasks):
+        """Waits for all branches of a parallel activity. Backends that can
+        observe completion join in completion order, such that a failing
+        branch is reported without waiting on the branches before it"""
+        for t in tasks:
+            await self.join(t)
+
+    async def offload(self, fn, *args):
+        """Runs a blocking or CPU-bound callable on behalf of an exec body.
+        Backends with worker pools run it outside the event loop"""
+        return fn(*args)
+
+    def close(self):
+        """Releases any worker resources held by the backend"""
+        pass
+
@@ -2,10 +2,24 @@
 import asyncio
 from .backend import Backend
 
+async def join_completed(aws):
+    """Awaits futures or tasks in completion order. On the first failure,
+    the remaining ones are cancelled and the exception is raised"""
+    try:
+        for f in asyncio.as_completed(aws):
+            await f
+    except BaseException:
+        for t in aws:
+            t.cancel()
+        raise
+
 class BackendAsyncio(Backend):
 
     def fork(self, coro):
         return asyncio.create_task(coro)
 
     async def join(self, task):
-        await task
+        return await task
+
+    async def join_all(self, tasks):
+        await join_completed(tasks)
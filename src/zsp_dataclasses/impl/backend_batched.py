@@ -0,0 +1,94 @@
+#****************************************************************************
+#* backend_batched.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+from .backend import Backend
+
+class BackendBatched(Backend):
+    """Groups forked branches into batches, each of which runs as a single
+    asyncio task that evaluates its branches in turn. This trades
+    concurrency between branches of the same batch for much lower
+    scheduling overhead, and suits parallel activities with many small
+    branches that rarely suspend.
+
+    Branches in a batch must not wait on each other (eg via a shared
+    event), since they are serialized"""
+
+    class Handle(object):
+
+        def __init__(self, batch, coro):
+            self.batch = batch
+            self.coro = coro
+            self.future = None
+
+    def __init__(self, batch_sz=64):
+        if batch_sz < 1:
+            raise Exception("batch_sz must be at least 1 (%d)" % batch_sz)
+        self._batch_sz = batch_sz
+        self._batch = []
+        self._n_batches = 0
+        # The loop only holds weak references to tasks, so keep each
+        # batch task alive until it completes
+        self._task_s = set()
+
+    @property
+    def n_batches(self):
+        """Number of scheduling units created so far"""
+        return self._n_batches
+
+    def fork(self, coro):
+        h = BackendBatched.Handle(self._batch, coro)
+        h.future = asyncio.get_running_loop().create_future()
+        self._batch.append(h)
+        if len(self._batch) >= self._batch_sz:
+            self._flush()
+        return h
+
+    async def join(self, task):
+        if task.batch is self._batch:
+            # Joining on a branch that hasn't been scheduled yet
+            self._flush()
+        return await task.future
+
+    def _flush(self):
+        batch = self._batch
+        self._batch = []
+        if len(batch) > 0:
+            self._n_batches += 1
+            task = asyncio.create_task(self._runBatch(batch))
+            self._task_s.add(task)
+            task.add_done_callback(self._task_s.discard)
+
+    async def _runBatch(self, batch):
+        try:
+            for h in batch:
+                try:
+                    h.future.set_result(await h.coro)
+                except Exception as e:
+                    h.future.set_exception(e)
+        finally:
+            # Branches left unevaluated by cancellation must not leave
+            # their joiners waiting
+            for h in batch:
+                if not h.future.done():
+                    h.coro.close()
+                    h.future.cancel()
+
@@ -0,0 +1,48 @@
+#****************************************************************************
+#* backend_processpool.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import functools
+from concurrent.futures import ProcessPoolExecutor
+from .backend_asyncio import BackendAsyncio
+
+class BackendProcessPool(BackendAsyncio):
+    """Offloads CPU-bound work from exec bodies to worker processes.
+
+    Parallel branches hold references to the native model evaluator, which
+    can't be transferred to another process. Branches are therefore
+    scheduled on the event loop as with BackendAsyncio, and only the
+    callables passed to offload() run in the process pool. These callables
+    (and their arguments and results) must be picklable"""
+
+    def __init__(self, max_workers=None, mp_context=None):
+        self._executor = ProcessPoolExecutor(
+            max_workers=max_workers,
+            mp_context=mp_context)
+
+    async def offload(self, fn, *args):
+        return await asyncio.get_running_loop().run_in_executor(
+            self._executor,
+            functools.partial(fn, *args))
+
+    def close(self):
+        self._executor.shutdown(wait=True)
+
@@ -0,0 +1,80 @@
+#****************************************************************************
+#* backend_threadpool.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import contextvars
+import functools
+import threading
+from concurrent.futures import ThreadPoolExecutor
+from .backend import Backend
+from .backend_asyncio import join_completed
+
+class BackendThreadPool(Backend):
+    """Evaluates each parallel branch in its own event loop on a worker
+    thread. Suited to exec bodies that block (DPI, transactor calls) or
+    that spend their time in native code that releases the GIL"""
+
+    def __init__(self, max_workers=None):
+        self._executor = ThreadPoolExecutor(
+            max_workers=max_workers,
+            thread_name_prefix="zsp_backend")
+        self._local = threading.local()
+
+    def fork(self, coro):
+        if getattr(self._local, "is_worker", False):
+            # Branches forked from a worker stay on that worker's loop.
+            # Waiting on the pool from a pool thread could otherwise
+            # deadlock once all workers are occupied
+            return asyncio.create_task(coro)
+        else:
+            # Branches run in the forking task's context, as tasks do,
+            # such that context-bound state (eg Ctor.bind) carries over
+            return asyncio.get_running_loop().run_in_executor(
+                self._executor,
+                self._runBranch,
+                contextvars.copy_context(),
+                coro)
+
+    async def join(self, task):
+        return await task
+
+    async def join_all(self, tasks):
+        await join_completed(tasks)
+
+    async def offload(self, fn, *args):
+        if getattr(self._local, "is_worker", False):
+            # Already running outside the main event loop
+            return fn(*args)
+        else:
+            return await asyncio.get_running_loop().run_in_executor(
+                self._executor,
+                functools.partial(contextvars.copy_context().run, fn, *args))
+
+    def close(self):
+        self._executor.shutdown(wait=True)
+
+    def _runBranch(self, ctxt, coro):
+        self._local.is_worker = True
+        try:
+            return ctxt.run(asyncio.run, coro)
+        finally:
+            self._local.is_worker = False
+
@@ -0,0 +1,343 @@
+#****************************************************************************
+#* backend_work_stealing.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import collections
+import contextvars
+import functools
+import itertools
+import os
+import threading
+import time
+from concurrent.futures import Future
+from .backend import Backend
+from .debug import Debug
+
+_dbg = Debug.get("backend")
+
+class BackendWorkStealing(Backend):
+    """Evaluates parallel branches on a fixed set of worker threads, each
+    running its own event loop. Branches forked on a worker are pushed to
+    that worker's deque, and idle workers steal the oldest branches from
+    the deques of busy ones. Each worker runs at most 'max_active'
+    branches at a time, not counting branches that wait in a join.
+
+    Joining a branch that hasn't started yet runs it in the joining task.
+    Nested parallels therefore mostly evaluate in place, and only stolen
+    branches cost a task. join_all() waits on the remaining branches in
+    completion order.
+
+    When 'record_timing' is set, a BranchTiming is appended to 'timing'
+    for each completed branch. The list grows with every branch, so only
+    enable it for runs being profiled"""
+
+    PENDING = 0
+    RUNNING = 1
+
+    class BranchTiming(object):
+        __slots__ = ("id", "parent", "worker", "t_fork", "t_start", "t_end")
+
+        def __init__(self, b):
+            self.id = b.id
+            self.parent = b.parent
+            # -1 for branches run by the thread that called eval
+            self.worker = b.worker
+            self.t_fork = b.t_fork
+            self.t_start = b.t_start
+            self.t_end = b.t_end
+
+        @property
+        def queued(self):
+            return self.t_start - self.t_fork
+
+        @property
+        def elapsed(self):
+            return self.t_end - self.t_start
+
+    class Branch(object):
+        __slots__ = ("id", "parent", "coro", "ctxt", "future", "owner",
+            "state", "worker", "t_fork", "t_start", "t_end")
+
+        def __init__(self, id, parent, coro, owner):
+            self.id = id
+            self.parent = parent
+            self.coro = coro
+            self.ctxt = contextvars.copy_context()
+            self.future = Future()
+            # Queue holding the branch. State changes are made under its lock
+            self.owner = owner
+            self.state = BackendWorkStealing.PENDING
+            self.worker = -1
+            self.t_fork = time.perf_counter()
+            self.t_start = 0.0
+            self.t_end = 0.0
+
+    class Queue(object):
+
+        def __init__(self, idx):
+            self.idx = idx
+            self.lock = threading.Lock()
+            self.deque = collections.deque()
+            # Branches of this queue run by a joiner, and taken by
+            # another worker. Both are updated under 'lock'
+            self.n_inline = 0
+            self.n_stolen = 0
+
+    class Worker(Queue):
+
+        def __init__(self, idx):
+            super().__init__(idx)
+            self.thread = None
+            self.loop = None
+            self.wake = None
+            self.idle = False
+            self.n_active = 0
+
+    def __init__(self, max_workers=None, max_active=16, record_timing=False):
+        if max_workers is None:
+            max_workers = os.cpu_count() or 1
+        if max_workers < 1:
+            raise Exception("max_workers must be at least 1 (%d)" % max_workers)
+        if max_active < 1:
+            raise Exception("max_active must be at least 1 (%d)" % max_active)
+        self._max_active = max_active
+        self._record_timing = record_timing
+        # Branches forked outside the workers
+        self._inject = BackendWorkStealing.Queue(-1)
+        self._worker_l = [BackendWorkStealing.Worker(i) for i in range(max_workers)]
+        self._local = threading.local()
+        self._branch_v = contextvars.ContextVar("zsp_dataclasses.Branch", default=-1)
+        self._start_lock = threading.Lock()
+        self._started = False
+        self._closed = False
+        # next() on a count is atomic, so ids are unique across threads
+        self._id_c = itertools.count()
+        self.timing = []
+
+    @property
+    def n_stolen(self):
+        """Branches that a worker took from another worker's deque"""
+        return sum(q.n_stolen for q in self._worker_l)
+
+    @property
+    def n_inline(self):
+        """Branches that ran in the task that joined them"""
+        return sum(q.n_inline for q in [self._inject] + self._worker_l)
+
+    def fork(self, coro):
+        if self._closed:
+            raise Exception("Backend is closed")
+        if not self._started:
+            self._start()
+        w = getattr(self._local, "worker", None)
+        q = self._inject if w is None else w
+
+        b = BackendWorkStealing.Branch(
+            next(self._id_c),
+            self._branch_v.get(),
+            coro,
+            q)
+        with q.lock:
+            q.deque.append(b)
+        self._notify(w)
+        return b
+
+    async def join(self, task):
+        if self._claim(task):
+            await self._run(task)
+        return await self._wait([task.future])
+
+    async def join_all(self, tasks):
+        # Branches that no worker has started run here, newest first. The
+        # oldest stay available to idle workers meanwhile
+        for b in reversed(tasks):
+            if self._claim(b):
+                await self._run(b)
+        await self._wait([b.future for b in tasks])
+
+    async def offload(self, fn, *args):
+        if getattr(self._local, "worker", None) is not None:
+            # Already running outside the main event loop
+            return fn(*args)
+        else:
+            return await asyncio.get_running_loop().run_in_executor(
+                None,
+                functools.partial(fn, *args))
+
+    def close(self):
+        if self._closed:
+            return
+        self._closed = True
+        # Branches that never started must not leave joiners waiting
+        for q in [self._inject] + self._worker_l:
+            with q.lock:
+                while len(q.deque) > 0:
+                    b = q.deque.popleft()
+                    if b.state == BackendWorkStealing.PENDING:
+                        b.state = BackendWorkStealing.RUNNING
+                        b.coro.close()
+                        b.future.cancel()
+        for w in self._worker_l:
+            if w.loop is not None:
+                w.loop.call_soon_threadsafe(w.wake.set)
+        for w in self._worker_l:
+            if w.thread is not None:
+                w.thread.join()
+
+    def _start(self):
+        with self._start_lock:
+            if self._started:
+                return
+            for w in self._worker_l:
+                w.thread = threading.Thread(
+                    target=self._workerMain,
+                    args=(w,),
+                    name="zsp_ws_%d" % w.idx,
+                    daemon=True)
+                w.thread.start()
+            self._started = True
+
+    def _workerMain(self, w):
+        self._local.worker = w
+        asyncio.run(self._dispatch(w))
+
+    async def _dispatch(self, w):
+        loop = asyncio.get_running_loop()
+        w.wake = asyncio.Event()
+        w.loop = loop
+        task_s = set()
+
+        while not self._closed:
+            w.wake.clear()
+            b = None
+            if w.n_active < self._max_active:
+                # Marked idle before looking, such that a concurrent fork
+                # always wakes this worker or is seen by it
+                w.idle = True
+                b = self._take(w)
+            if b is None:
+                await w.wake.wait()
+                w.idle = False
+                continue
+            w.idle = False
+            w.n_active += 1
+            t = b.ctxt.run(loop.create_task, self._runTask(w, b))
+            task_s.add(t)
+            t.add_done_callback(task_s.discard)
+
+        # Let running branches complete, such that their joiners are released
+        if len(task_s) > 0:
+            await asyncio.wait(task_s)
+
+    async def _runTask(self, w, b):
+        try:
+            await self._run(b)
+        finally:
+            w.n_active -= 1
+            w.wake.set()
+
+    async def _run(self, b):
+        w = getattr(self._local, "worker", None)
+        b.worker = -1 if w is None else w.idx
+        b.t_start = time.perf_counter()
+        token = self._branch_v.set(b.id)
+        ret = exc = None
+        try:
+            ret = await b.coro
+        except BaseException as e:
+            exc = e
+        finally:
+            self._branch_v.reset(token)
+
+        # Timing is recorded before joiners are released
+        b.t_end = time.perf_counter()
+        if self._record_timing:
+            self.timing.append(BackendWorkStealing.BranchTiming(b))
+        if exc is None:
+            b.future.set_result(ret)
+        else:
+            b.future.set_exception(exc)
+            if not isinstance(exc, Exception):
+                raise exc
+
+    async def _wait(self, futures):
+        """Waits on branches running elsewhere. The calling branch doesn't
+        count against its worker's limit while it waits"""
+        w = getattr(self._local, "worker", None)
+        if w is not None:
+            w.n_active -= 1
+            w.wake.set()
+        try:
+            ret = None
+            for f in asyncio.as_completed([asyncio.wrap_future(f) for f in futures]):
+                ret = await f
+            return ret
+        finally:
+            if w is not None:
+                w.n_active += 1
+
+    def _claim(self, b):
+        """Claims a pending branch to run in the joining task"""
+        with b.owner.lock:
+            if b.state == BackendWorkStealing.PENDING:
+                b.state = BackendWorkStealing.RUNNING
+                b.owner.n_inline += 1
+                return True
+        return False
+
+    def _take(self, w):
+        """Returns the next branch for worker 'w': its own newest branch,
+        else the oldest injected branch, else the oldest branch of another
+        worker"""
+        with w.lock:
+            while len(w.deque) > 0:
+                b = w.deque.pop()
+                if b.state == BackendWorkStealing.PENDING:
+                    b.state = BackendWorkStealing.RUNNING
+                    return b
+
+        for ii in range(len(self._worker_l)+1):
+            if ii == 0:
+                q = self._inject
+            else:
+                q = self._worker_l[(w.idx + ii) % len(self._worker_l)]
+                if q is w:
+                    continue
+            with q.lock:
+                while len(q.deque) > 0:
+                    b = q.deque.popleft()
+                    if b.state == BackendWorkStealing.PENDING:
+                        b.state = BackendWorkStealing.RUNNING
+                        if q is not self._inject:
+                            q.n_stolen += 1
+                        return b
+        return None
+
+    def _notify(self, self_w):
+        for w in self._worker_l:
+            if w.idle and w is not self_w and w.loop is not None:
+                if _dbg.en:
+                    _dbg.debug("Wake worker %d" % w.idx)
+                w.idle = False
+                w.loop.call_soon_threadsafe(w.wake.set)
+                return
+        if self_w is not None:
+            self_w.wake.set()
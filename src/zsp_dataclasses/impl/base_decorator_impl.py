@@ -7,6 +7,9 @@ from .activity_decl import ActivityDecl
 
 from .exec_type import ExecType
 from .type_info import TypeInfo
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 class BaseDecoratorImpl(vsc_impl.RandClassDecoratorImpl):
 
@@ -15,8 +18,9 @@ class BaseDecoratorImpl(vsc_impl.RandClassDecoratorImpl):
 
         # collect exec blocks registers in this scope
         for exec_ti in typeworks.DeclRgy.pop_decl(ExecType, typeworks.scopename(T)):
-            print("Add exec block %s %s" % (str(exec_ti), str(T)))
-            print("  annotations: %s" % str(exec_ti.func.__annotations__))
+            if _dbg.en:
+                _dbg.debug("Add exec block %s %s" % (str(exec_ti), str(T)))
+                _dbg.debug("  annotations: %s" % str(exec_ti.func.__annotations__))
             base_ti.addExec(exec_ti)
         
         # Now, link up the 'super' relationships
@@ -0,0 +1,73 @@
+#****************************************************************************
+#* buf_t.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import array
+
+class BufT(object):
+    """Type hint for import-function parameters that take a buffer. The
+    target implementation receives a memoryview of the caller's storage"""
+    pass
+
+class BufField(object):
+    """Fixed-size buffer attribute of an action or struct. The storage 
+    (a bytearray, or an array.array for other item types) isn't part of
+    the solver model. It is allocated on first access, and is kept when
+    the facade is reused for a later traversal"""
+
+    def __init__(self, size, typecode="B"):
+        if size < 0:
+            raise Exception("Buffer size must be non-negative (%d)" % size)
+        # Validates 'typecode'
+        self.itemsize = array.array(typecode).itemsize
+        self.size = size
+        self.typecode = typecode
+        self.name = None
+        self._attr = None
+
+    def __set_name__(self, owner, name):
+        self.name = name
+        self._attr = "_buf_%s" % name
+
+    def __get__(self, obj, objtype=None):
+        if obj is None:
+            return self
+        d = object.__getattribute__(obj, "__dict__")
+        ret = d.get(self._attr, None)
+        if ret is None:
+            ret = self.mkStorage()
+            d[self._attr] = ret
+        return ret
+
+    def __set__(self, obj, value):
+        # Copy into the existing storage, such that views taken 
+        # earlier (eg by an outstanding target call) remain valid
+        dst = memoryview(self.__get__(obj)).cast("B")
+        src = memoryview(value).cast("B")
+        if src.nbytes != dst.nbytes:
+            raise Exception("Buffer %s holds %d bytes, but the value has %d" % (
+                self.name, dst.nbytes, src.nbytes))
+        dst[:] = src
+
+    def mkStorage(self):
+        if self.typecode == "B":
+            return bytearray(self.size)
+        else:
+            return array.array(self.typecode, bytes(self.size * self.itemsize))
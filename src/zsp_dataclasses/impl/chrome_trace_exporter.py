@@ -0,0 +1,154 @@
+#****************************************************************************
+#* chrome_trace_exporter.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import contextvars
+import itertools
+import json
+import os
+import threading
+import time
+from .eval_listener import EvalListener
+
+class ChromeTraceExporter(EvalListener):
+    """Records evaluation events in the Chrome trace-event format, which
+    both chrome://tracing and Perfetto load. Each eval and each parallel
+    branch is a track of its own, on which its solver steps and action
+    bodies are duration events. Branches that interleave on one thread
+    (eg under BackendAsyncio) therefore don't mis-nest. Parallel fan-out
+    and branch queue depth are counters"""
+
+    def __init__(self):
+        self._t0 = time.perf_counter()
+        self._pid = os.getpid()
+        self._lock = threading.Lock()
+        self._tid_m = {}
+        # (track id, begin time, enclosing track) of the current eval or
+        # branch. Branch coroutines run in their own context, or inline
+        # in the joining one, which end() then restores
+        self._track = contextvars.ContextVar("chrome_trace_track", default=None)
+        self._track_c = itertools.count(1)
+        self._n_queued = 0
+        self._n_outstanding = 0
+        self.events = []
+
+    def _us(self, t):
+        return (t - self._t0) * 1e6
+
+    def _tid(self):
+        track = self._track.get()
+        if track is not None:
+            return track[0]
+        tid = threading.get_ident()
+        if tid not in self._tid_m.keys():
+            self._tid_m[tid] = threading.current_thread().name
+        return tid
+
+    def _beginTrack(self, name, t):
+        tid = next(self._track_c)
+        self._tid_m[tid] = name
+        self._track.set((tid, t, self._track.get()))
+
+    def _endTrack(self):
+        """Returns the begin time of the current track, and makes the
+        enclosing track current"""
+        tid, t_begin, prev = self._track.get()
+        self._track.set(prev)
+        return tid, t_begin
+
+    def _complete(self, name, cat, t_start, t_end, args=None, tid=None):
+        ev = {
+            "name" : name,
+            "cat" : cat,
+            "ph" : "X",
+            "ts" : self._us(t_start),
+            "dur" : self._us(t_end) - self._us(t_start),
+            "pid" : self._pid,
+            "tid" : self._tid() if tid is None else tid
+        }
+        if args is not None:
+            ev["args"] = args
+        self.events.append(ev)
+
+    def _counter(self, name, t, args):
+        self.events.append({
+            "name" : name,
+            "ph" : "C",
+            "ts" : self._us(t),
+            "pid" : self._pid,
+            "args" : args
+        })
+
+    def evalBegin(self, action_t, t):
+        self._beginTrack("eval %s" % action_t.__qualname__, t)
+
+    def evalEnd(self, action_t, t):
+        tid, t_begin = self._endTrack()
+        self._complete(
+            "eval %s" % action_t.__qualname__, "eval", t_begin, t, tid=tid)
+
+    def solveStep(self, t_start, t_end, n_nodes):
+        self._complete("solve", "solve", t_start, t_end, {"nodes" : n_nodes})
+
+    def action(self, action, t_start, t_end, cpu):
+        self._complete(
+            type(action).__qualname__, "action", t_start, t_end, {"cpu_us" : cpu * 1e6})
+
+    def fork(self, t, n_branches, depth):
+        with self._lock:
+            self._n_queued += n_branches
+            self._n_outstanding += n_branches
+            n_queued, n_outstanding = self._n_queued, self._n_outstanding
+        self._counter("fan-out", t, {"branches" : n_branches})
+        self._counter("branches", t, {"queued" : n_queued, "outstanding" : n_outstanding})
+
+    def branchBegin(self, t, depth):
+        self._beginTrack("branch (depth %d)" % depth, t)
+        with self._lock:
+            self._n_queued -= 1
+            n_queued, n_outstanding = self._n_queued, self._n_outstanding
+        self._counter("branches", t, {"queued" : n_queued, "outstanding" : n_outstanding})
+
+    def branchEnd(self, t, depth):
+        tid, t_begin = self._endTrack()
+        self._complete("branch", "branch", t_begin, t, {"depth" : depth}, tid=tid)
+        with self._lock:
+            self._n_outstanding -= 1
+            n_queued, n_outstanding = self._n_queued, self._n_outstanding
+        self._counter("branches", t, {"queued" : n_queued, "outstanding" : n_outstanding})
+
+    def trace(self):
+        meta = []
+        for tid,name in self._tid_m.items():
+            meta.append({
+                "name" : "thread_name",
+                "ph" : "M",
+                "pid" : self._pid,
+                "tid" : tid,
+                "args" : {"name" : name}
+            })
+        return {
+            "traceEvents" : meta + self.events,
+            "displayTimeUnit" : "ms"
+        }
+
+    def write(self, path):
+        with open(path, "w") as fp:
+            json.dump(self.trace(), fp)
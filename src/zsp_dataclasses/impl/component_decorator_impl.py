@@ -42,6 +42,9 @@ from .ctor import Ctor
 from .type_kind_e import TypeKindE
 from .typeinfo_action import TypeInfoAction
 from .typeinfo_component import TypeInfoComponent
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 
 class ComponentDecoratorImpl(BaseDecoratorImpl):
@@ -67,7 +70,8 @@ class ComponentDecoratorImpl(BaseDecoratorImpl):
         else:
             raise Exception("Type %s is already registered" % name)
 
-        print("Create Component datatype %s" % name)
+        if _dbg.en:
+            _dbg.debug("Create Component datatype %s" % name)
         
         return ds_t
 
@@ -86,11 +90,13 @@ class ComponentDecoratorImpl(BaseDecoratorImpl):
         component_ti = TypeInfoComponent.get(self.get_typeinfo())
         value_ti = typeworks.TypeInfo.get(value, False)
 
-        print("init_annotated_field: %s %s" % (key, str(value)))
+        if _dbg.en:
+            _dbg.debug("init_annotated_field: %s %s" % (key, str(value)))
 
         if issubclass(value, (PoolT,PoolMetaSzT)):
             ctor_a = Ctor.inst()
-            print("is pool")
+            if _dbg.en:
+                _dbg.debug("is pool")
             ctor = vsc_impl.Ctor.inst()
             # TODO: extract typeinfo for field type
             pool_t_ti = typeworks.TypeInfo.get(value.T, False)
@@ -109,7 +115,8 @@ class ComponentDecoratorImpl(BaseDecoratorImpl):
 
             if has_init:
                 if isinstance(init, BindAllImpl):
-                    print("Have bind-all")
+                    if _dbg.en:
+                        _dbg.debug("Have bind-all")
                     pool_ref = ctor_a.ctxt().mkTypeExprFieldRef()
                     pool_ref.addIdxRef(pool_fi.idx)
                     pool_ref.addRootRef()
@@ -141,7 +148,8 @@ class ComponentDecoratorImpl(BaseDecoratorImpl):
                     field_fi = vsc_impl.TypeInfoField(key, value_base_ti)
                     component_ti.addField(field_fi, field_type_obj)
 
-                    print("TypeInfoRegGroup")
+                    if _dbg.en:
+                        _dbg.debug("TypeInfoRegGroup")
                     self.set_field_initial(key, None)
                 elif isinstance(value_base_ti, TypeInfoComponent):
                     ctor = vsc_impl.Ctor.inst()
@@ -4,6 +4,7 @@ Created on Apr 4, 2022
 @author: mballance
 '''
 
+import time
 import vsc_dataclasses.impl as vsc_impl
 
 from .backend_asyncio import BackendAsyncio
@@ -16,14 +17,33 @@ from .exec_kind_e import ExecKindE
 from .exec_group import ExecGroup
 from .rt_ctxt import RtCtxt
 from .impl_base import ImplBase
+from .model_eval_batch import ModelEvalBatch
+from .resource_allocator import ResourceAllocator
+from .eval_listener import EvalListenerList
+from .debug import Debug
+
+_dbg = Debug.get("component")
 
 class ComponentImpl(ImplBase):
     """Methods added to Component-decorated classes"""
 
     @staticmethod
     def setBackend(self, backend):
+        """Selects the backend that schedules parallel branches during eval
+        (eg BackendAsyncio, BackendThreadPool, BackendProcessPool, 
+        BackendBatched)"""
         self.backend = backend
 
+    @staticmethod
+    def addEvalListener(self, listener):
+        """Adds a listener (eg EvalProfiler, ChromeTraceExporter) that
+        receives events from subsequent eval calls"""
+        self.eval_listeners.append(listener)
+
+    @staticmethod
+    def removeEvalListener(self, listener):
+        self.eval_listeners.remove(listener)
+
     @staticmethod
     def getBackend(self):
         if self.backend is None:
@@ -52,11 +72,23 @@ class ComponentImpl(ImplBase):
     #     return field
     
     @staticmethod
-    async def eval(self, action_t):
-        randstate = vsc_impl.RandState.mk()
+    async def eval(self, action_t, batch_sz=ModelEvalBatch.DEFAULT_BATCH_SZ, seed=None):
+        """Evaluates a scenario rooted at action type 'action_t'. Up to
+        'batch_sz' consecutive action nodes are fetched from the evaluator
+        (and solved) ahead of dispatching their exec bodies. Values other
+        than 1 trade strict solve/exec interleaving for fewer calls into 
+        the evaluator. When 'seed' is specified, evaluation is repeatable
+        for that seed"""
+        if seed is None:
+            randstate = vsc_impl.RandState.mk()
+        else:
+            randstate = vsc_impl.RandState.mkFromSeed(seed)
 
         ctor_v = vsc_impl.Ctor.inst()
-        print("ComponentImpl.eval %d" % len(ctor_v._scope_s))
+        if _dbg.en:
+            _dbg.debug("ComponentImpl.eval %d" % len(ctor_v._scope_s))
+        if batch_sz < 1:
+            raise Exception("batch_sz must be at least 1 (%d)" % batch_sz)
         ctor = Ctor.inst()
         ev = ctor.ctxt().mkModelEvaluator()
         action_ti = TypeInfoAction.get(action_t._typeinfo)
@@ -65,70 +97,121 @@ class ComponentImpl(ImplBase):
             self._modelinfo.libobj,
             action_ti._lib_typeobj)
 
-        print("Iterating...")        
-        await self._evalThread(it, 0)
+        # Each evaluation has its own runtime context, such that concurrent
+        # eval calls don't share exec-group state. This also makes the
+        # backend visible to exec bodies (eg for offload)
+        listener = EvalListenerList.mk(self.eval_listeners)
+        with RtCtxt.bind(RtCtxt(self.getBackend(), ResourceAllocator(), listener)):
+            if _dbg.en:
+                _dbg.debug("Iterating...")        
+            if listener is not None:
+                listener.evalBegin(action_t, time.perf_counter())
+            try:
+                await self._evalThread(it, 0, batch_sz)
+            finally:
+                # Listeners see the end of an evaluation that fails, too
+                if listener is not None:
+                    listener.evalEnd(action_t, time.perf_counter())
 
     @staticmethod
-    async def _evalThread(self, it, depth):
-        backend = self.getBackend()
+    async def _evalBranch(self, it, depth, batch_sz, rt_ctxt):
+        # Parallel branches interleave, and so must not share
+        # the exec-group stack of the parent thread
+        listener = rt_ctxt.listener
+        with RtCtxt.bind(rt_ctxt):
+            if listener is None:
+                await self._evalThread(it, depth, batch_sz)
+            else:
+                listener.branchBegin(time.perf_counter(), depth)
+                try:
+                    await self._evalThread(it, depth, batch_sz)
+                finally:
+                    listener.branchEnd(time.perf_counter(), depth)
+
+    @staticmethod
+    async def _evalParallel(self, branch_it, depth, batch_sz, backend):
+        """Forks each branch of 'branch_it' onto the backend, then waits for
+        all of them. Any node whose branches may run concurrently (eg a 
+        future schedule node) is evaluated the same way"""
+        rt_ctxt = RtCtxt.inst()
+        branch_l = []
+        branch_it_v = branch_it.next()
+        while branch_it_v:
+            branch_l.append(branch_it.iterator())
+            branch_it_v = branch_it.next()
+
+        if rt_ctxt.listener is not None:
+            rt_ctxt.listener.fork(time.perf_counter(), len(branch_l), depth)
+
+        # Create a coroutine for each branch
+        task_l = []
+        for branch in branch_l:
+            if _dbg.en:
+                _dbg.debug("Fork branch depth=%d" % (depth+1))
+            task_l.append(backend.fork(
+                self._evalBranch(branch, depth+1, batch_sz, rt_ctxt.mkBranch())))
+
+        # Branches are joined as they complete, such that a failing branch
+        # is reported without waiting on the slowest one
+        await backend.join_all(task_l)
 
-        valid = it.next()
-        print("Initial: valid=%s" % valid)
-        while valid:
-
-            print("Next: %s depth=%d" % (it.type(), depth), flush=True)
-            if it.type() == ModelEvalNodeT.Action:
-                action_field = it.action()
-                print("action_field: %s" % str(action_field))
-                print("--> invoke getFieldData", flush=True)
-                action = action_field.getFieldData()
-
-                comp_ref_f = action_field.getField(0) # Get Component field
-                comp = comp_ref_f.getRef()
-
-                if comp is None:
-                    raise Exception("Internal error: comp handle is null")
-
-#                action.comp = comp.getFieldData()
-                print("<-- invoke getFieldData", flush=True)
-                print("--> invoke evalExecTarget", flush=True)
-                await action._evalExecTarget(ExecKindE.Body)
-                print("<-- invoke evalExecTarget", flush=True)
-            
-                print("Action: %s" % str(action))
-
-                # Advance the iterator
-                valid = it.next()
-            elif it.type() == ModelEvalNodeT.Parallel:
-                branch_it = it.iterator()
-
-                # Advance the iterator off the parallel
-                valid = it.next()
-
-                task_l = []
-                # Wait for coroutines to complete
-                print("TODO: evaluate parallel")
-                # Create a coroutine for each branch
-                branch_it_v = branch_it.next()
-                while branch_it_v:
-
-                    branch = branch_it.iterator()
-                    branch_it_v = branch_it.next()
-                    print("Task:", flush=True)
-                    # TODO: create a new co-routine task (pass thread iterator)
-                    task_l.append(backend.fork(self._evalThread(branch, depth+1)))
-
-                print("TODO: join")
-                for t in task_l:
-                    await backend.join(t)
-                # TODO: join on all branches
-                    pass
-            elif it.type() == ModelEvalNodeT.Sequence:
-                # Iterate through each item and dispatch
-                print("TODO: evaluate sequence")
-                pass
+    @staticmethod
+    async def _evalThread(self, it, depth, batch_sz=ModelEvalBatch.DEFAULT_BATCH_SZ):
+        backend = self.getBackend()
+        reuse_actions = Ctor.inst().reuse_actions
+        resources = RtCtxt.inst().resources
+        listener = RtCtxt.inst().listener
+
+        reader = ModelEvalBatch(it)
+        while True:
+            if listener is None:
+                batch = reader.next(batch_sz)
             else:
-                raise Exception("Unknown iteration type %s" % it.type())
+                t_start = time.perf_counter()
+                batch = reader.next(batch_sz)
+                listener.solveStep(t_start, time.perf_counter(), len(batch))
+            if len(batch) == 0:
+                break
+            if _dbg.en:
+                _dbg.debug("Batch: %d nodes depth=%d" % (len(batch), depth))
+
+            for node in batch:
+                if node.kind == ModelEvalNodeT.Action:
+                    action_ti = TypeInfoAction.get(type(node.action)._typeinfo)
+                    grant = None
+                    if len(action_ti.claims) > 0 and resources is not None:
+                        # Claimed resources are held while the body runs
+                        grant = await resources.acquire(node.field, action_ti.claims)
+                    try:
+                        if _dbg.en:
+                            _dbg.debug("--> invoke evalExecTarget %s" % str(node.field))
+                        if listener is None:
+                            await node.action._evalExecTarget(ExecKindE.Body)
+                        else:
+                            t_start = time.perf_counter()
+                            cpu_start = time.thread_time()
+                            await node.action._evalExecTarget(ExecKindE.Body)
+                            listener.action(
+                                node.action,
+                                t_start,
+                                time.perf_counter(),
+                                time.thread_time() - cpu_start)
+                        if _dbg.en:
+                            _dbg.debug("<-- invoke evalExecTarget %s" % str(node.action))
+                    finally:
+                        if grant is not None:
+                            resources.release(grant)
+                    if reuse_actions:
+                        action_ti.release(node.action)
+                elif node.kind == ModelEvalNodeT.Parallel:
+                    await self._evalParallel(node.iterator, depth, batch_sz, backend)
+                elif node.kind == ModelEvalNodeT.Sequence:
+                    # Items of a sequence are evaluated in order, on 
+                    # the current thread
+                    await self._evalThread(node.iterator, depth+1, batch_sz)
+                else:
+                    raise Exception("Unknown iteration type %s" % node.kind)
+            ModelEvalBatch.release(batch)
         
     @staticmethod
     def _createInst(cls, name):
@@ -143,6 +226,10 @@ class ComponentImpl(ImplBase):
 #            self, base_init, *args, **kwargs))
         setattr(T, "setBackend", cls.setBackend)
         setattr(T, "getBackend", cls.getBackend)
+        setattr(T, "addEvalListener", cls.addEvalListener)
+        setattr(T, "removeEvalListener", cls.removeEvalListener)
         setattr(T, "eval", cls.eval)
+        setattr(T, "_evalBranch", cls._evalBranch)
+        setattr(T, "_evalParallel", cls._evalParallel)
         setattr(T, "_evalThread", cls._evalThread)
         
\ No newline at end of file
@@ -60,6 +60,9 @@ class DataTypeActivityReplicate(DataTypeActivityScope):
     def getCount(self) -> 'TypeExpr':
         pass
 
+class DataTypeActivitySequence(DataTypeActivityScope):
+    pass
+
 class DataTypeActivityTraverse(DataTypeActivity):
 
     def getTarget(self) -> vsc_ctxt.TypeExprFieldRef:
@@ -178,6 +181,38 @@ class ModelBuildContext(vsc_ctxt.ModelBuildContext):
 
 class ModelEvalNodeT(IntEnum):
     Action = 0
+    Parallel = 1
+    Sequence = 2
+
+class ModelEvalIterator(object):
+
+    def next(self) -> bool:
+        raise NotImplementedError("next")
+
+    def type(self) -> ModelEvalNodeT:
+        raise NotImplementedError("type")
+
+    def action(self) -> vsc_ctxt.ModelField:
+        raise NotImplementedError("action")
+
+    def iterator(self) -> 'ModelEvalIterator':
+        raise NotImplementedError("iterator")
+
+    def nextBatch(self, max_n) -> List['ModelEvalNode']:
+        """Optional. Advances over up to max_n nodes in one call, returning
+        ModelEvalNode-like objects with action data already extracted. A
+        batch ends early after the first non-action node, and an empty 
+        batch indicates the end of iteration. Returns None when batching
+        isn't supported, in which case the caller steps with next()"""
+        return None
+
+class ModelEvaluator(object):
+
+    def eval(self, 
+             randstate, 
+             root_comp : 'ModelFieldComponent', 
+             root_action : DataTypeAction) -> ModelEvalIterator:
+        raise NotImplementedError("eval")
 
 class ModelFieldComponent(vsc_ctxt.ModelField):
 
@@ -216,6 +251,16 @@ class TypeExprMethodCallContext(TypeExprMethodCallStatic):
     def getContext(self):
         raise NotImplementedError("getContext")
 
+class TypeExprArrIndex(vsc_ctxt.TypeExpr):
+    """Element 'index' of the array field referenced by 'root', such as
+    an element of a register array"""
+
+    def getRootExpr(self) -> vsc_ctxt.TypeExprFieldRef:
+        raise NotImplementedError("getRootExpr")
+
+    def getIndexExpr(self) -> vsc_ctxt.TypeExpr:
+        raise NotImplementedError("getIndexExpr")
+
 class TypeFieldActivity(vsc_ctxt.TypeField):
 
     def mkActivity(self, ctxt : ModelBuildContext):
@@ -228,6 +273,21 @@ class TypeFieldReg(vsc_ctxt.TypeField):
     
     def setOffset(self, off):
         raise NotImplementedError("setOffset")
+
+    def getCount(self):
+        """Number of elements of a register array. 0 for a single register"""
+        raise NotImplementedError("getCount")
+
+    def setCount(self, count):
+        raise NotImplementedError("setCount")
+
+    def getStride(self):
+        """Address increment between register-array elements. 0 selects
+        the register size"""
+        raise NotImplementedError("getStride")
+
+    def setStride(self, stride):
+        raise NotImplementedError("setStride")
     
 class TypeFieldRegGroup(vsc_ctxt.TypeField):
     def getOffset(self):
@@ -286,6 +346,14 @@ class Context(vsc.impl.Context):
     def mkDataTypeAction(self, name) -> DataTypeAction:
         raise NotImplementedError("mkDataTypeAction")
 
+    def findDataTypeActionHandle(self, name) -> int:
+        """Returns the handle of action type 'name', or -1 if there is no
+        such type. Handles remain valid for the life of the context"""
+        raise NotImplementedError("findDataTypeActionHandle")
+
+    def getDataTypeActionByHandle(self, h) -> 'DataTypeAction':
+        raise NotImplementedError("getDataTypeActionByHandle")
+
     def addDataTypeAction(self, t : DataTypeAction) -> bool:
         raise NotImplementedError("addDataTypeAction")
 
@@ -307,6 +375,12 @@ class Context(vsc.impl.Context):
     def findDataTypeComponent(self, name) -> 'DataTypeComponent':
         raise NotImplementedError("findDataTypeComponent")
 
+    def findDataTypeComponentHandle(self, name) -> int:
+        raise NotImplementedError("findDataTypeComponentHandle")
+
+    def getDataTypeComponentByHandle(self, h) -> 'DataTypeComponent':
+        raise NotImplementedError("getDataTypeComponentByHandle")
+
     def mkDataTypeComponent(self, name) -> 'DataTypeComponent':
         raise NotImplementedError("mkDataTypeComponent")
 
@@ -329,6 +403,12 @@ class Context(vsc.impl.Context):
     def findDataTypeFunction(self, name):
         raise NotImplementedError("findDataTypeFunction")
     
+    def findDataTypeFunctionHandle(self, name) -> int:
+        raise NotImplementedError("findDataTypeFunctionHandle")
+    
+    def getDataTypeFunctionByHandle(self, h):
+        raise NotImplementedError("getDataTypeFunctionByHandle")
+    
     def mkDataTypeFunctionImport(self,
                                 lang,
                                 is_target,
@@ -343,11 +423,19 @@ class Context(vsc.impl.Context):
                                 init : vsc_ctxt.TypeExpr) -> DataTypeFunctionParamDecl:
         raise NotImplementedError("mkDataTypeFunctionParamDecl")
 
+    def mkModelEvaluator(self) -> 'ModelEvaluator':
+        raise NotImplementedError("mkModelEvaluator")
+
     def mkTypeExec(self,
                    kind,
                    body):
         raise NotImplementedError("mkTypeExec")
     
+    def mkTypeExprArrIndex(self,
+                           root : vsc_ctxt.TypeExprFieldRef,
+                           index : vsc_ctxt.TypeExpr) -> TypeExprArrIndex:
+        raise NotImplementedError("mkTypeExprArrIndex")
+
     def mkTypeExprMethodCallContext(self,
                                 target : DataTypeFunction,
                                 context,
@@ -4,12 +4,21 @@ Created on Mar 19, 2022
 @author: mballance
 '''
 
+import contextlib
+import contextvars
 import typeworks
 
 from enum import Enum, auto
 from vsc_dataclasses.impl.ctor import Ctor as VscCtor
 from .type_kind_e import TypeKindE
 from .ctor_scope import CtorScope
+from .debug import Debug
+
+_dbg = Debug.get("ctor")
+
+# Constructor bound to the current context by Ctor.bind(). Falls back
+# to the process-wide instance created by Ctor.init()
+_ctor_v = contextvars.ContextVar("zsp_dataclasses.Ctor", default=None)
 
 class CtxtE(Enum):
     Constraint = auto()
@@ -18,9 +27,14 @@ class CtxtE(Enum):
 
 class Ctor(object):
     _inst = None
+    _sym_m = {}
+    _sym_l = []
     
     def __init__(self):
         self._is_elab = False
+        self._in_elab = False
+        self._elab_func_s = set()
+        self._elab_comp_s = set()
         self._component_type_m = {}
         self._exec_type_l = []
         self._ctxt = None
@@ -39,6 +53,29 @@ class Ctor(object):
         self._activity_s = []
         self._proc_scope_s = []
         self._ctxt_type_l = []
+        self._core_fn_l = []
+        # Depth of lazy-facade creation. Facades created late belong to a
+        # tree whose initialization sequence has already run
+        self._materialize_depth = 0
+        # When set, subcomponent facades of non-type-mode components are
+        # created on first access
+        self.lazy_comp = False
+        # When set, facades of completed actions back later traversals
+        # during eval, rather than being discarded
+        self.reuse_actions = False
+        # When set, init execs of component instances run closures built
+        # from the exec IR captured when the type was elaborated, rather
+        # than re-running the Python body for each instance
+        self.shared_init = False
+        # When set along with shared_init, those execs are lowered to C++
+        # and run from a compiled library (see ExecCompiler). Types whose
+        # execs can't be lowered use the closures
+        self.compile_execs = False
+        self._exec_compiler = None
+        # When set, redundant equality and range bindings are removed
+        # from traversal with-clauses before they reach the solver. Off
+        # by default, since nothing consumes the resulting plan yet
+        self.precompile_with = False
 
         pass
     
@@ -46,31 +83,138 @@ class Ctor(object):
         if self._ctxt is None:
             raise Exception("No backend provided for arl_dataclasses")
         return self._ctxt
+
+    def execCompiler(self) -> 'ExecCompiler':
+        """Returns the compiler used for compile_execs, which caches each
+        library it builds"""
+        if self._exec_compiler is None:
+            from .exec_compiler import ExecCompiler
+            self._exec_compiler = ExecCompiler()
+        return self._exec_compiler
+
+    def memStats(self, *roots, classes=True) -> 'MemSnapshot':
+        """Returns object counts and approximate bytes of the elaborated
+        types and of the facades reachable from 'roots' (eg a root
+        component). See MemStats"""
+        from .mem_stats import MemStats
+        return MemStats(self._ctxt).snapshot(*roots, classes=classes)
+
+    @staticmethod
+    def sym(name) -> int:
+        """Interns core-library function 'name', returning a symbol for
+        use with core_fn(). Symbols are process-wide, and are typically
+        interned once at module scope"""
+        ret = Ctor._sym_m.get(name, None)
+        if ret is None:
+            ret = len(Ctor._sym_l)
+            Ctor._sym_l.append(name)
+            Ctor._sym_m[name] = ret
+        return ret
+
+    def core_fn(self, sym):
+        """Returns the core-library function identified by symbol 'sym' 
+        (or by name). Functions are resolved once per constructor, since 
+        they belong to its context"""
+        if isinstance(sym, str):
+            sym = Ctor.sym(sym)
+        if sym < len(self._core_fn_l):
+            ret = self._core_fn_l[sym]
+            if ret is not None:
+                return ret
+        else:
+            self._core_fn_l.extend([None]*(len(Ctor._sym_l)-len(self._core_fn_l)))
+
+        name = Ctor._sym_l[sym]
+        ret = self.ctxt().findDataTypeFunction(name)
+        if ret is None:
+            raise Exception("Core-library function %s not found" % name)
+        self._core_fn_l[sym] = ret
+        return ret
     
     def elab(self):
+        """Elaborates functions and components registered since the 
+        previous call. Safe to call repeatedly, such that types declared 
+        after the first elaboration are elaborated on demand"""
         from .type_info import TypeInfo
-        if self._is_elab:
-            print("Skip elab")
+        if self._in_elab:
+            # Elaboration constructs type instances, which re-enter here
             return
-        self._is_elab = True
+        self._in_elab = True
 
-        functions = typeworks.TypeRgy.get_methods(TypeKindE.Function)
-        print("Elab with %d functions" % len(functions))
+        try:
+            functions = list(filter(
+                lambda f: f not in self._elab_func_s,
+                typeworks.TypeRgy.get_methods(TypeKindE.Function)))
+            if _dbg.en:
+                _dbg.debug("Elab with %d new functions" % len(functions))
 
-        for f in functions:
-            f.elab_decl()
+            # Declare all new functions before elaborating any bodies,
+            # since bodies may reference each other
+            for f in functions:
+                self._elab_func_s.add(f)
+                f.elab_decl()
 
-        for f in functions:
-            f.elab_body()
+            for f in functions:
+                f.elab_body()
 
-        components = typeworks.TypeRgy.get_types(TypeKindE.Component)
-        print("Elab with %d components" % len(components))
-        
-        for c in components:
-            c_ti = TypeInfo.get(c)
-            c_ti.elab()
+            # Elaboration is tracked per Ctor, such that a new context
+            # also receives components elaborated into an earlier one
+            components = list(filter(
+                lambda c: c not in self._elab_comp_s or TypeInfo.get(c).has_pending_actions,
+                typeworks.TypeRgy.get_types(TypeKindE.Component)))
+            if _dbg.en:
+                _dbg.debug("Elab with %d new components" % len(components))
         
+            for c in components:
+                self._elab_comp_s.add(c)
+                c_ti = TypeInfo.get(c)
+                if not c_ti.is_elab:
+                    c_ti.elab()
+                else:
+                    c_ti.elabPendingActions()
+                    # The type model was built by an earlier context, 
+                    # and is complete. Register it with this context
+                    self._importComponent(c_ti)
+        finally:
+            self._in_elab = False
+
+        self._is_elab = True
+
     
+    def _importComponent(self, c_ti):
+        """Registers the data types of component 'c_ti', its actions, and
+        the struct types their fields reference, with the current context.
+        Names already registered (eg by a type redefined for this 
+        context) are left alone"""
+        import vsc_dataclasses.impl.context as vsc_ctxt
+        from .context import DataTypeAction, DataTypeComponent
+        ctxt = self.ctxt()
+        ctxt.addDataTypeComponent(c_ti.lib_typeobj)
+        seen = set()
+        type_l = [c_ti.lib_typeobj] + [a.lib_typeobj for a in c_ti._action_t]
+        while len(type_l) > 0:
+            t = type_l.pop()
+            if id(t) in seen:
+                continue
+            seen.add(id(t))
+            if isinstance(t, DataTypeAction):
+                ctxt.addDataTypeAction(t)
+            elif isinstance(t, DataTypeComponent):
+                # Sub-components are imported along with their own type
+                if t is not c_ti.lib_typeobj:
+                    continue
+            elif isinstance(t, vsc_ctxt.DataTypeStruct):
+                if ctxt.findDataTypeStruct(t.name()) is None:
+                    ctxt.addDataTypeStruct(t)
+            else:
+                continue
+            for f in t.getFields():
+                dt = f.getDataType()
+                if dt is not None:
+                    type_l.append(dt)
+        if _dbg.en:
+            _dbg.debug("Imported %d types of %s" % (len(seen), c_ti.info.T.__name__))
+
     def scope(self):
         if len(self._scope_s) > 0:
             return self._scope_s[-1]
@@ -163,9 +307,11 @@ class Ctor(object):
         ps = self._proc_scope_s.pop()
 
         for e in vsc_ctor.pop_exprs():
-            print("e.model: %s %s" % (str(e.model), isinstance(e.model, vsc_ctxt.TypeExprBin)))
+            if _dbg.en:
+                _dbg.debug("e.model: %s %s" % (str(e.model), isinstance(e.model, vsc_ctxt.TypeExprBin)))
             if isinstance(e.model, vsc_ctxt.TypeExprBin) and e.model.op() == vsc_ctxt.BinOp.Eq:
-                print("Add assign statement")
+                if _dbg.en:
+                    _dbg.debug("Add assign statement")
                 ps.addStatement(self._ctxt.mkTypeProcStmtAssign(
                     e.model.lhs(),
                     ctxt_api.TypeProcStmtAssignOp.Eq,
@@ -208,10 +354,12 @@ class Ctor(object):
         field = action_ti.createTypeInst()
         ctor.pop_scope()
 
-        print("Scope for tempvar is: %s" % str(ctor.bottom_up_mi()))
+        if _dbg.en:
+            _dbg.debug("Scope for tempvar is: %s" % str(ctor.bottom_up_mi()))
         field._modelinfo.idx = len(ctor.bottom_up_mi()._subfield_modelinfo)
         ctor.bottom_up_mi().addSubfield(field._modelinfo)
-        print("field._modelinfo.parent=%s" % str(field._modelinfo._parent))
+        if _dbg.en:
+            _dbg.debug("field._modelinfo.parent=%s" % str(field._modelinfo._parent))
 
         return (field_t, field)
         
@@ -266,9 +414,12 @@ class Ctor(object):
     
     @classmethod
     def inst(cls):
-        if cls._inst is None:
-            cls._inst = Ctor()
-        return cls._inst
+        ret = _ctor_v.get(None)
+        if ret is None:
+            if cls._inst is None:
+                cls._inst = Ctor()
+            ret = cls._inst
+        return ret
 
     @classmethod
     def init(cls, ctxt):
@@ -276,4 +427,28 @@ class Ctor(object):
         cls._inst = Ctor()
         cls._inst._ctxt = ctxt
 
+    @classmethod
+    def mk(cls, ctxt) -> 'Ctor':
+        """Creates a constructor for 'ctxt' without making it the
+        process-wide default. Activate it with bind()"""
+        ret = Ctor()
+        ret._ctxt = ctxt
+        return ret
+
+    @staticmethod
+    @contextlib.contextmanager
+    def bind(ctor):
+        """Makes 'ctor' the constructor returned by inst() within the 
+        current context (thread or asyncio task, and any tasks created 
+        from it) for the duration of the with block.
+
+        Note that the vsc constructor remains process-wide. Declaring
+        types must still be serialized, even when bound to different
+        constructors"""
+        token = _ctor_v.set(ctor)
+        try:
+            yield ctor
+        finally:
+            _ctor_v.reset(token)
+
     
\ No newline at end of file
@@ -0,0 +1,138 @@
+#****************************************************************************
+#* debug.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import logging
+import os
+
+class Debug(object):
+    """Per-subsystem debug logger. Log points are guarded at the call site:
+
+        if _dbg.en:
+            _dbg.debug("msg %s" % str(v))
+
+    so a disabled log point costs one attribute test, and neither formats
+    its message nor enters the logging framework. Output is routed through
+    the 'zsp_dataclasses.<subsystem>' Python logger.
+
+    Subsystems are enabled with Debug.configure(), or via the environment:
+        ZSP_DATACLASSES_DEBUG=component,typeinfo=INFO
+        ZSP_DATACLASSES_DEBUG=*
+    """
+
+    ENV_VAR = "ZSP_DATACLASSES_DEBUG"
+    LOGGER_ROOT = "zsp_dataclasses"
+
+    _inst_m = {}
+    _spec_m = None
+
+    def __init__(self, name):
+        self.name = name
+        self.logger = logging.getLogger("%s.%s" % (Debug.LOGGER_ROOT, name))
+        self.level = logging.NOTSET
+        self.en = False
+        self.info_en = False
+
+    def debug(self, msg, *args):
+        self.logger.debug(msg, *args)
+
+    def info(self, msg, *args):
+        self.logger.info(msg, *args)
+
+    def setLevel(self, level):
+        if isinstance(level, str):
+            level = logging.getLevelName(level.upper())
+            if not isinstance(level, int):
+                raise Exception("Unknown debug level %s" % str(level))
+        self.level = level
+        self.logger.setLevel(level)
+        self._update()
+
+    def _update(self):
+        self.en = self.logger.isEnabledFor(logging.DEBUG)
+        self.info_en = self.logger.isEnabledFor(logging.INFO)
+
+    @staticmethod
+    def get(name) -> 'Debug':
+        if Debug._spec_m is None:
+            Debug._initSpec()
+        if name not in Debug._inst_m.keys():
+            dbg = Debug(name)
+            Debug._inst_m[name] = dbg
+            level = Debug._spec_m.get(name, Debug._spec_m.get("*", None))
+            if level is not None:
+                dbg.setLevel(level)
+            else:
+                dbg._update()
+        return Debug._inst_m[name]
+
+    @staticmethod
+    def configure(spec):
+        """Applies a spec of the form 'name[=LEVEL],...' ('*' for all
+        subsystems) on top of the current settings. Also accepts a dict
+        of name->level"""
+        if isinstance(spec, str):
+            spec = Debug._parseSpec(spec)
+        if Debug._spec_m is None:
+            Debug._initSpec()
+        Debug._spec_m.update(spec)
+        Debug._ensureHandler()
+        for name,dbg in Debug._inst_m.items():
+            level = spec.get(name, spec.get("*", None))
+            if level is not None:
+                dbg.setLevel(level)
+
+    @staticmethod
+    def update():
+        """Re-evaluates the enable flags after the logging configuration
+        was changed directly through the logging module"""
+        for dbg in Debug._inst_m.values():
+            dbg._update()
+
+    @staticmethod
+    def _initSpec():
+        Debug._spec_m = Debug._parseSpec(os.environ.get(Debug.ENV_VAR, ""))
+        Debug._ensureHandler()
+
+    @staticmethod
+    def _parseSpec(spec):
+        spec_m = {}
+        for elem in spec.split(","):
+            elem = elem.strip()
+            if elem == "":
+                continue
+            if "=" in elem:
+                name,level = elem.split("=", 1)
+                spec_m[name.strip()] = level.strip()
+            else:
+                spec_m[elem] = "DEBUG"
+        return spec_m
+
+    @staticmethod
+    def _ensureHandler():
+        # Only install a handler when debug was requested and the
+        # application hasn't configured logging itself
+        if len(Debug._spec_m) == 0:
+            return
+        root = logging.getLogger(Debug.LOGGER_ROOT)
+        if len(root.handlers) == 0 and not logging.getLogger().hasHandlers():
+            handler = logging.StreamHandler()
+            handler.setFormatter(logging.Formatter("[%(name)s] %(message)s"))
+            root.addHandler(handler)
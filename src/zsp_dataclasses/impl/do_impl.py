@@ -4,11 +4,15 @@ import vsc_dataclasses.impl.context as vsc_ctxt
 from .activity_traverse_closure import ActivityTraverseClosure
 from .ctor import Ctor
 from .typeinfo_action import TypeInfoAction
+from .debug import Debug
+
+_dbg = Debug.get("action")
 
 class DoImpl(object):
 
     def __init__(self, *args, **kwargs):
-        print("DoImpl: %s" % str(kwargs))
+        if _dbg.en:
+            _dbg.debug("DoImpl: %s" % str(kwargs))
         pass
 
     def __getitem__(self, T):
@@ -19,7 +23,8 @@ class DoImpl(object):
             raise Exception("Type %s is not an action" % str(T))
         action_ti = TypeInfoAction.get(ti)
 
-        print("DoImplMeta: %s" % str(action_ti.lib_typeobj), flush=True)
+        if _dbg.en:
+            _dbg.debug("DoImplMeta: %s" % str(action_ti.lib_typeobj))
         
         # Add a field declaration to the activity scope
         field_t = ctor_a.ctxt().mkTypeFieldPhy(
@@ -39,7 +44,8 @@ class DoImpl(object):
         dt_traverse = ctor_a.ctxt().mkDataTypeActivityTraverse(
             target,
             None)
-        print("dt_traverse: %s" % str(dt_traverse), flush=True)
+        if _dbg.en:
+            _dbg.debug("dt_traverse: %s" % str(dt_traverse))
         ft_traverse = ctor_a.ctxt().mkTypeFieldActivity(
             "",
             dt_traverse,
@@ -11,6 +11,9 @@ import vsc_dataclasses.impl.context as vsc_ctxt
 from .activity_traverse_closure import ActivityTraverseClosure
 from .type_info import TypeInfo
 from .typeinfo_action import TypeInfoAction
+from .debug import Debug
+
+_dbg = Debug.get("action")
 
 class DoImplMeta(type):
 
@@ -26,7 +29,8 @@ class DoImplMeta(type):
             raise Exception("Type %s is not an action" % str(item))
         action_ti = TypeInfoAction.get(ti)
 
-        print("DoImplMeta: %s" % str(action_ti.lib_typeobj), flush=True)
+        if _dbg.en:
+            _dbg.debug("DoImplMeta: %s" % str(action_ti.lib_typeobj))
 
         field_t, field = ctor_a.add_anonymous_traversal(action_ti)
 
@@ -44,7 +48,8 @@ class DoImplMeta(type):
         dt_traverse = ctor_a.ctxt().mkDataTypeActivityTraverse(
             target,
             None)
-        print("dt_traverse: %s" % str(dt_traverse), flush=True)
+        if _dbg.en:
+            _dbg.debug("dt_traverse: %s" % str(dt_traverse))
         ft_traverse = ctor_a.ctxt().mkTypeFieldActivity(
             "",
             dt_traverse,
@@ -0,0 +1,98 @@
+#****************************************************************************
+#* eval_listener.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+
+class EvalListener(object):
+    """Receives events from ComponentImpl.eval. Times are perf_counter
+    seconds, and CPU times are thread_time seconds. Methods may be called
+    concurrently from several threads when the backend has workers"""
+
+    def evalBegin(self, action_t, t):
+        pass
+
+    def evalEnd(self, action_t, t):
+        """Called when eval completes, including when it raises"""
+        pass
+
+    def solveStep(self, t_start, t_end, n_nodes):
+        """Fetching and solving a batch of 'n_nodes' evaluation nodes"""
+        pass
+
+    def action(self, action, t_start, t_end, cpu):
+        """Completion of the body of 'action'. 'cpu' is the thread's CPU
+        time across the awaited body. It includes CPU time used by other
+        coroutines that ran on the thread while the body was suspended"""
+        pass
+
+    def fork(self, t, n_branches, depth):
+        """A parallel node at 'depth' is about to fork 'n_branches'"""
+        pass
+
+    def branchBegin(self, t, depth):
+        pass
+
+    def branchEnd(self, t, depth):
+        pass
+
+class EvalListenerList(EvalListener):
+    """Forwards events to several listeners"""
+
+    def __init__(self, listener_l):
+        self.listener_l = list(listener_l)
+
+    def evalBegin(self, action_t, t):
+        for l in self.listener_l:
+            l.evalBegin(action_t, t)
+
+    def evalEnd(self, action_t, t):
+        for l in self.listener_l:
+            l.evalEnd(action_t, t)
+
+    def solveStep(self, t_start, t_end, n_nodes):
+        for l in self.listener_l:
+            l.solveStep(t_start, t_end, n_nodes)
+
+    def action(self, action, t_start, t_end, cpu):
+        for l in self.listener_l:
+            l.action(action, t_start, t_end, cpu)
+
+    def fork(self, t, n_branches, depth):
+        for l in self.listener_l:
+            l.fork(t, n_branches, depth)
+
+    def branchBegin(self, t, depth):
+        for l in self.listener_l:
+            l.branchBegin(t, depth)
+
+    def branchEnd(self, t, depth):
+        for l in self.listener_l:
+            l.branchEnd(t, depth)
+
+    @staticmethod
+    def mk(listener_l):
+        """Returns None, the only listener, or a list of listeners, such
+        that evaluation only pays for dispatch when it is needed"""
+        if len(listener_l) == 0:
+            return None
+        elif len(listener_l) == 1:
+            return listener_l[0]
+        else:
+            return EvalListenerList(listener_l)
@@ -0,0 +1,125 @@
+#****************************************************************************
+#* eval_profiler.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import threading
+from .eval_listener import EvalListener
+
+class EvalProfiler(EvalListener):
+    """Aggregates evaluation events: per action-type counts and times,
+    solver-step latency, parallel fan-out, and the number of forked
+    branches that have not started (queued) or not completed
+    (outstanding)"""
+
+    class ActionStats(object):
+        __slots__ = ("count", "wall", "cpu", "wall_max")
+
+        def __init__(self):
+            self.count = 0
+            self.wall = 0.0
+            self.cpu = 0.0
+            self.wall_max = 0.0
+
+    class Stats(object):
+        """Count, total, and maximum of a sampled quantity"""
+        __slots__ = ("count", "total", "max")
+
+        def __init__(self):
+            self.count = 0
+            self.total = 0
+            self.max = 0
+
+        def add(self, v):
+            self.count += 1
+            self.total += v
+            if v > self.max:
+                self.max = v
+
+        @property
+        def mean(self):
+            return (self.total / self.count) if self.count > 0 else 0
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.action_m = {}
+        self.solve = EvalProfiler.Stats()
+        self.solve_nodes = EvalProfiler.Stats()
+        self.fanout = EvalProfiler.Stats()
+        self.queued = EvalProfiler.Stats()
+        self.outstanding = EvalProfiler.Stats()
+        self._n_queued = 0
+        self._n_outstanding = 0
+        self.t_eval = 0.0
+
+    def evalBegin(self, action_t, t):
+        self._t_begin = t
+
+    def evalEnd(self, action_t, t):
+        self.t_eval += t - self._t_begin
+
+    def solveStep(self, t_start, t_end, n_nodes):
+        with self._lock:
+            self.solve.add(t_end - t_start)
+            self.solve_nodes.add(n_nodes)
+
+    def action(self, action, t_start, t_end, cpu):
+        name = type(action).__qualname__
+        wall = t_end - t_start
+        with self._lock:
+            s = self.action_m.get(name, None)
+            if s is None:
+                s = EvalProfiler.ActionStats()
+                self.action_m[name] = s
+            s.count += 1
+            s.wall += wall
+            s.cpu += cpu
+            if wall > s.wall_max:
+                s.wall_max = wall
+
+    def fork(self, t, n_branches, depth):
+        with self._lock:
+            self.fanout.add(n_branches)
+            self._n_queued += n_branches
+            self._n_outstanding += n_branches
+            self.queued.add(self._n_queued)
+            self.outstanding.add(self._n_outstanding)
+
+    def branchBegin(self, t, depth):
+        with self._lock:
+            self._n_queued -= 1
+
+    def branchEnd(self, t, depth):
+        with self._lock:
+            self._n_outstanding -= 1
+
+    def report(self) -> str:
+        """Returns a text summary, with action types by total time"""
+        ret = []
+        ret.append("Evaluation: %.6fs" % self.t_eval)
+        ret.append("Solve steps: %d (mean %.6fs, max %.6fs, %.1f nodes/step)" % (
+            self.solve.count, self.solve.mean, self.solve.max, self.solve_nodes.mean))
+        ret.append("Parallel forks: %d (mean fan-out %.1f, max %d, max queued %d, max outstanding %d)" % (
+            self.fanout.count, self.fanout.mean, self.fanout.max,
+            self.queued.max, self.outstanding.max))
+        ret.append("%-40s %8s %12s %12s %12s" % ("Action", "Count", "Wall(s)", "CPU(s)", "Max(s)"))
+        for name,s in sorted(self.action_m.items(), key=lambda e: -e[1].wall):
+            ret.append("%-40s %8d %12.6f %12.6f %12.6f" % (
+                name, s.count, s.wall, s.cpu, s.wall_max))
+        return "\n".join(ret)
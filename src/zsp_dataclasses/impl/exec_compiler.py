@@ -0,0 +1,285 @@
+#****************************************************************************
+#* exec_compiler.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import ctypes
+import hashlib
+import os
+import shlex
+import subprocess
+import tempfile
+import threading
+from .debug import Debug
+
+_dbg = Debug.get("gen")
+
+ReadFieldF = ctypes.CFUNCTYPE(
+    ctypes.c_uint64,
+    ctypes.c_void_p, ctypes.c_void_p,
+    ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.POINTER(ctypes.c_int32))
+WriteFieldF = ctypes.CFUNCTYPE(
+    None,
+    ctypes.c_void_p, ctypes.c_void_p,
+    ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.POINTER(ctypes.c_int32),
+    ctypes.c_uint64)
+CallF = ctypes.CFUNCTYPE(
+    ctypes.c_uint64,
+    ctypes.c_void_p, ctypes.c_void_p, ctypes.c_int32,
+    ctypes.c_int32, ctypes.c_int32, ctypes.c_int32, ctypes.POINTER(ctypes.c_int32),
+    ctypes.c_int64,
+    ctypes.c_int32, ctypes.POINTER(ctypes.c_uint64))
+
+class ExecApi(ctypes.Structure):
+    """ctypes mirror of zsp_exec_api_t. Evaluators normally provide this
+    table natively; building it from Python callables is mainly useful
+    for testing compiled bodies"""
+    _fields_ = [
+        ("read_field", ReadFieldF),
+        ("write_field", WriteFieldF),
+        ("call", CallF),
+        ("user", ctypes.c_void_p)
+    ]
+
+    @staticmethod
+    def mk(read_field, write_field, call) -> 'ExecApi':
+        """Python callables receive (kind, offset, path) for field
+        references, and (fn_name, ctxt_ref, args) for calls, where a
+        reference is a (kind, offset, path) tuple or None. A reference
+        to an array element is (kind, offset, path, index). Calls to
+        functions with destination parameters (eg reg_read_block) return
+        a sequence of values, which is stored to the argument array"""
+        api = ExecApi()
+        call_names = []
+
+        def _path(n, p):
+            return tuple(p[ii] for ii in range(n))
+
+        def _read(api_p, self_p, kind, off, n, p):
+            return read_field(kind, off, _path(n, p))
+        def _write(api_p, self_p, kind, off, n, p, v):
+            write_field(kind, off, _path(n, p), v)
+        def _call(api_p, self_p, fn_id, kind, off, n, p, index, argc, argv):
+            if n == 0:
+                ref = None
+            elif index < 0:
+                ref = (kind, off, _path(n, p))
+            else:
+                ref = (kind, off, _path(n, p), index)
+            ret = call(api.call_names[fn_id], ref, tuple(argv[ii] for ii in range(argc)))
+            if isinstance(ret, (list, tuple)):
+                for ii,v in enumerate(ret[:argc]):
+                    argv[ii] = v
+                ret = 0
+            return ret or 0
+
+        api.read_field = ReadFieldF(_read)
+        api.write_field = WriteFieldF(_write)
+        api.call = CallF(_call)
+        # The callback objects must live as long as the table
+        api.call_names = call_names
+        api._keep = (_read, _write, _call)
+        return api
+
+class ExecEntry(ctypes.Structure):
+    _fields_ = [
+        ("name", ctypes.c_char_p),
+        ("func", ctypes.c_void_p)
+    ]
+
+ExecF = ctypes.CFUNCTYPE(
+    ctypes.c_uint64,
+    ctypes.POINTER(ExecApi), ctypes.c_void_p, ctypes.POINTER(ctypes.c_uint64))
+
+class ExecLib(object):
+    """Compiled exec/function bodies loaded from a shared library. Entry
+    points are resolved once, when the library is loaded"""
+
+    def __init__(self, path, prefix="zsp"):
+        self.path = path
+        self._lib = ctypes.CDLL(path)
+        entries = (ExecEntry * 1).in_dll(self._lib, "%s_exec_entries" % prefix)
+        entries = ctypes.cast(ctypes.byref(entries), ctypes.POINTER(ExecEntry))
+        self._func_m = {}
+        ii = 0
+        while entries[ii].name is not None:
+            self._func_m[entries[ii].name.decode()] = ExecF(entries[ii].func)
+            ii += 1
+
+        names = ctypes.cast(
+            ctypes.byref((ctypes.c_char_p * 1).in_dll(self._lib, "%s_exec_call_names" % prefix)),
+            ctypes.POINTER(ctypes.c_char_p))
+        self.call_names = []
+        ii = 0
+        while names[ii] is not None:
+            self.call_names.append(names[ii].decode())
+            ii += 1
+
+    def names(self):
+        return self._func_m.keys()
+
+    def get(self, name):
+        if name not in self._func_m.keys():
+            raise Exception("No compiled body named %s in %s" % (name, self.path))
+        return self._func_m[name]
+
+    def call(self, name, api : ExecApi, args=(), self_p=None):
+        if hasattr(api, "call_names"):
+            api.call_names[:] = self.call_names
+        argv = (ctypes.c_uint64 * max(1, len(args)))(*args)
+        return self.get(name)(ctypes.byref(api), self_p, argv)
+
+class ExecModelRunner(object):
+    """Runs compiled bodies of type 'dt' against the fields of model
+    objects of that type (see Ctor.compile_execs). Field references are
+    resolved relative to the root field passed to the callables from
+    mkRun(). Bodies must not call functions without a body, since no
+    call handler is available"""
+
+    def __init__(self, lib : ExecLib, dt):
+        self.lib = lib
+        self.dt = dt
+        self._tls = threading.local()
+        # Path to (is_signed, value mask) of the field's type
+        self._kind_m = {}
+        self._api = ExecApi.mk(self._read, self._write, self._call)
+        self._api.call_names[:] = lib.call_names
+
+    def mkRun(self, name):
+        """Returns a callable f(root) that runs body 'name'"""
+        func = self.lib.get(name)
+        api = self._api
+
+        def run(root):
+            tls = self._tls
+            prev = getattr(tls, "root", None)
+            tls.root = root
+            tls.err = None
+            try:
+                func(ctypes.byref(api), None, None)
+            finally:
+                tls.root = prev
+            # Exceptions don't propagate through the C frames. Callbacks
+            # record them, and they're raised once the body returns
+            if tls.err is not None:
+                err = tls.err
+                tls.err = None
+                raise err
+        return run
+
+    def _field(self, kind, off, path):
+        if kind != 0 or off != 0:
+            raise Exception("Unsupported field reference (kind %d, offset %d)" % (kind, off))
+        f = self._tls.root
+        for p in path:
+            f = f.getField(p)
+        return f
+
+    def _read(self, kind, off, path):
+        try:
+            return self._field(kind, off, path).val().val_i() & 0xFFFFFFFFFFFFFFFF
+        except Exception as e:
+            self._err(e)
+            return 0
+
+    def _write(self, kind, off, path, v):
+        try:
+            signed, mask = self._fieldKind(path)
+            if signed:
+                if v >= (1 << 63):
+                    v -= (1 << 64)
+                self._field(kind, off, path).val().set_val_i(v)
+            else:
+                # Values are truncated to the field, as in the C++ type
+                self._field(kind, off, path).val().set_val_u(v & mask)
+        except Exception as e:
+            self._err(e)
+
+    def _call(self, name, ref, args):
+        self._err(Exception(
+            "Function %s has no body, and no call handler was provided" % name))
+        return 0
+
+    def _err(self, e):
+        # The first error is the one reported
+        if self._tls.err is None:
+            self._tls.err = e
+
+    def _fieldKind(self, path):
+        """Returns (is_signed, value mask) for the field at 'path'"""
+        ret = self._kind_m.get(path, None)
+        if ret is None:
+            t = self.dt
+            for p in path:
+                t = t.getFields()[p].getDataType()
+            if hasattr(t, "is_signed"):
+                ret = (t.is_signed(), (1 << min(t.width(), 64))-1)
+            else:
+                ret = (False, 0xFFFFFFFFFFFFFFFF)
+            self._kind_m[path] = ret
+        return ret
+
+class ExecCompiler(object):
+    """Compiles generated exec C++ into shared libraries. Libraries are
+    cached by a hash of the source, compiler, and flags, such that each
+    body is only compiled once"""
+
+    def __init__(self, cache_dir=None, cxx=None, cxxflags=None):
+        if cache_dir is None:
+            cache_dir = os.path.join(tempfile.gettempdir(), "zsp_exec_cache")
+        self._cache_dir = cache_dir
+        self._cxx = cxx if cxx is not None else os.environ.get("CXX", "c++")
+        if cxxflags is None:
+            cxxflags = ["-O2", "-fPIC", "-shared", "-std=c++11"]
+        self._cxxflags = list(cxxflags)
+        self._lib_m = {}
+
+    def compile(self, src, prefix="zsp") -> ExecLib:
+        h = hashlib.sha256()
+        for v in (self._cxx, " ".join(self._cxxflags), src):
+            h.update(v.encode())
+            h.update(b"\0")
+        key = h.hexdigest()[:24]
+
+        if key in self._lib_m.keys():
+            return self._lib_m[key]
+
+        os.makedirs(self._cache_dir, exist_ok=True)
+        lib_path = os.path.join(self._cache_dir, "exec_%s.so" % key)
+
+        if not os.path.isfile(lib_path):
+            src_path = os.path.join(self._cache_dir, "exec_%s.cpp" % key)
+            tmp_path = "%s.%d.tmp" % (lib_path, os.getpid())
+            with open(src_path, "w") as fp:
+                fp.write(src)
+            cmd = shlex.split(self._cxx) + self._cxxflags + ["-o", tmp_path, src_path]
+            if _dbg.en:
+                _dbg.debug("Compile: %s" % " ".join(cmd))
+            res = subprocess.run(cmd, capture_output=True, text=True)
+            if res.returncode != 0:
+                raise Exception("Failed to compile exec bodies (%s):\n%s" % (
+                    " ".join(cmd), res.stderr))
+            # Concurrent compiles of the same source produce identical
+            # libraries, so the last rename wins harmlessly
+            os.replace(tmp_path, lib_path)
+
+        lib = ExecLib(lib_path, prefix)
+        self._lib_m[key] = lib
+        return lib
+
@@ -10,6 +10,9 @@ import typeworks
 from .exec_type import ExecType
 from .exec_kind_e import ExecKindE
 from .ctor import Ctor
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 class ExecDecoratorImpl(typeworks.RegistrationDecoratorBase):
     
@@ -18,8 +21,9 @@ class ExecDecoratorImpl(typeworks.RegistrationDecoratorBase):
         self._kind = kind
 
     def register_decl(self, T):
-        print("Register exec: %s %s" % (T.__name__, hasattr(T, "__annotations__")))
-        print("  %s" % str(T.__annotations__))
+        if _dbg.en:
+            _dbg.debug("Register exec: %s %s" % (T.__name__, hasattr(T, "__annotations__")))
+            _dbg.debug("  %s" % str(T.__annotations__))
 
 #        if self._kind == ExecKindE.Body:
 #            if not inspect.iscoroutinefunction(T):
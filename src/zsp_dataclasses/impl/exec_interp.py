@@ -0,0 +1,316 @@
+#****************************************************************************
+#* exec_interp.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import operator
+import vsc_dataclasses.impl.context as vsc_ctxt
+from .context import TypeExprArrIndex, TypeExprMethodCallContext, TypeExprMethodCallStatic
+from .context import TypeProcStmtAssignOp
+from .pyctxt.visitor_base import VisitorBase
+from .debug import Debug
+
+_dbg = Debug.get("exec")
+
+class ExecInterp(VisitorBase):
+    """Builds Python closures from exec IR (TypeProcStmt*). A body is
+    built once, and the resulting callable is run against any model
+    field of the type: 'f(root)'. Field references are relative to the
+    root, so instances share the closure.
+
+    Functions with a body are built on first call. Calls to functions
+    without a body go to 'call(name, ctxt_field, args)'. For functions
+    with destination parameters (eg reg_read_block), 'call' returns one
+    value per parameter, which is stored to each destination. The context
+    of a call on an array element (eg of a register array) is passed as
+    (array field, index)"""
+
+    BINOP_M = {
+        "Eq" : lambda a, b: int(a == b), "Ne" : lambda a, b: int(a != b),
+        "Gt" : lambda a, b: int(a > b), "Ge" : lambda a, b: int(a >= b),
+        "Lt" : lambda a, b: int(a < b), "Le" : lambda a, b: int(a <= b),
+        "Add" : operator.add, "Sub" : operator.sub, "Mul" : operator.mul,
+        "Div" : operator.floordiv, "Mod" : operator.mod,
+        "BinAnd" : operator.and_, "BinOr" : operator.or_,
+        "Xor" : operator.xor, "BinXor" : operator.xor,
+        "Sll" : operator.lshift, "Srl" : operator.rshift
+    }
+
+    class CallCheck(VisitorBase):
+        """Finds calls to functions without a body, including calls made
+        by the bodies of called functions"""
+
+        def __init__(self):
+            super().__init__()
+            self.fn_s = set()
+            self.found = False
+
+        def visitTypeExprMethodCallContext(self, i):
+            self.found = True
+
+        def visitTypeExprMethodCallStatic(self, i):
+            target = i.getTarget()
+            if len(target.getImportSpecs()) > 0 or target.getBody() is None:
+                self.found = True
+            elif target.name() not in self.fn_s:
+                self.fn_s.add(target.name())
+                target.getBody().accept(self)
+            for p in i.getParameters():
+                p.accept(self)
+
+    def __init__(self, call=None):
+        super().__init__()
+        self._call = call
+        self._fn_m = {}
+        self._depth = 0
+        self._ret = None
+
+    @staticmethod
+    def needsCall(body):
+        """Returns whether running 'body' calls a function without a body,
+        which requires a call handler"""
+        check = ExecInterp.CallCheck()
+        body.accept(check)
+        return check.found
+
+    def build(self, body, n_params=0):
+        """Returns a callable f(root, args=()) that runs 'body'"""
+        if _dbg.en:
+            _dbg.debug("Build exec body %s" % str(body))
+        depth = self._depth
+        self._depth = 1
+        try:
+            stmt = self._build(body)
+        finally:
+            self._depth = depth
+
+        def run(root, args=()):
+            # Parameters form the outer-most variable scope
+            stmt(root, [list(args)])
+        return run
+
+    def _build(self, i):
+        self._ret = None
+        i.accept(self)
+        if self._ret is None:
+            raise Exception("Unsupported exec statement or expression %s" % str(i))
+        ret = self._ret
+        self._ret = None
+        return ret
+
+    def visitTypeExec(self, i):
+        self._ret = self._build(i.getBody())
+
+    def visitTypeProcStmtScope(self, i):
+        self._depth += 1
+        try:
+            init_l = []
+            for v in i.getVariables():
+                init_l.append(self._build(v.getInit()) if v.getInit() is not None else None)
+            stmt_l = tuple(self._build(s) for s in i.getStatements())
+        finally:
+            self._depth -= 1
+        init_l = tuple(init_l)
+
+        def scope(root, env):
+            env.append([(0 if e is None else e(root, env)) for e in init_l])
+            try:
+                for s in stmt_l:
+                    s(root, env)
+            finally:
+                env.pop()
+        self._ret = scope
+
+    def visitTypeProcStmtAssign(self, i):
+        if i.op() != TypeProcStmtAssignOp.Eq:
+            raise Exception("Unsupported assignment operator %s" % str(i.op()))
+        rhs = self._build(i.getRhs())
+        lhs = i.getLhs()
+        local = self._localRef(lhs)
+        if local is not None:
+            s_idx, v_idx = local
+            def assign(root, env):
+                env[s_idx][v_idx] = rhs(root, env)
+        elif isinstance(lhs, vsc_ctxt.TypeExprFieldRef):
+            path = self._fieldPath(lhs)
+            def assign(root, env):
+                f = root
+                for p in path:
+                    f = f.getField(p)
+                f.val().set_val_i(rhs(root, env))
+        else:
+            raise Exception("Unsupported assignment target %s" % str(lhs))
+        self._ret = assign
+
+    def visitTypeProcStmtExpr(self, i):
+        from .generators.exec_cpp_gen import ExecCppGen
+        e = i.getExpr()
+        if (isinstance(e, TypeExprMethodCallStatic) and 
+                e.getTarget().name() in ExecCppGen.OUT_ARG_FN_S):
+            self._ret = self._buildOutArgCall(e)
+        else:
+            self._ret = self._build(e)
+
+    def _buildOutArgCall(self, i):
+        name = i.getTarget().name()
+        if self._call is None:
+            raise Exception("Function %s has no body, and no call handler was provided" % name)
+        call = self._call
+        ctxt = i.getContext() if isinstance(i, TypeExprMethodCallContext) else None
+        ctxt_f = self._buildCtxt(ctxt)
+
+        store_l = []
+        for dst in i.getParameters():
+            local = self._localRef(dst)
+            if local is not None:
+                store_l.append((local, None))
+            elif isinstance(dst, vsc_ctxt.TypeExprFieldRef):
+                store_l.append((None, self._fieldPath(dst)))
+            else:
+                raise Exception("Unsupported destination %s for %s" % (str(dst), name))
+        store_l = tuple(store_l)
+
+        def call_out(root, env):
+            # As with compiled code, the callee fills a zeroed buffer
+            ret = call(name, ctxt_f(root, env), [0]*len(store_l))
+            for (local,path),v in zip(store_l, ret):
+                if local is not None:
+                    env[local[0]][local[1]] = v
+                else:
+                    f = root
+                    for p in path:
+                        f = f.getField(p)
+                    f.val().set_val_i(v)
+            return 0
+        return call_out
+
+    def visitTypeProcStmtIfElse(self, i):
+        cond = self._build(i.getCond())
+        true_s = self._build(i.getTrue())
+        false_s = self._build(i.getFalse()) if i.getFalse() is not None else None
+
+        def if_else(root, env):
+            if cond(root, env):
+                true_s(root, env)
+            elif false_s is not None:
+                false_s(root, env)
+        self._ret = if_else
+
+    def visitTypeExprBin(self, i):
+        op = i.op()
+        name = op.name if hasattr(op, "name") else str(op)
+        lhs = self._build(i.lhs())
+        rhs = self._build(i.rhs())
+        if name == "LogAnd":
+            self._ret = lambda root, env: int(bool(lhs(root, env)) and bool(rhs(root, env)))
+        elif name == "LogOr":
+            self._ret = lambda root, env: int(bool(lhs(root, env)) or bool(rhs(root, env)))
+        elif name in ExecInterp.BINOP_M.keys():
+            op_f = ExecInterp.BINOP_M[name]
+            self._ret = lambda root, env: op_f(lhs(root, env), rhs(root, env))
+        else:
+            raise Exception("Unsupported binary operator %s" % name)
+
+    def visitTypeExprVal(self, i):
+        v = i.val().val_i()
+        self._ret = lambda root, env: v
+
+    def visitTypeExprFieldRef(self, i):
+        local = self._localRef(i)
+        if local is not None:
+            s_idx, v_idx = local
+            self._ret = lambda root, env: env[s_idx][v_idx]
+        else:
+            path = self._fieldPath(i)
+            def read(root, env):
+                f = root
+                for p in path:
+                    f = f.getField(p)
+                return f.val().val_i()
+            self._ret = read
+
+    def visitTypeExprMethodCallStatic(self, i):
+        self._ret = self._buildCall(i, None)
+
+    def visitTypeExprMethodCallContext(self, i):
+        self._ret = self._buildCall(i, i.getContext())
+
+    def _buildCall(self, i, ctxt):
+        target = i.getTarget()
+        name = target.name()
+        arg_l = tuple(self._build(p) for p in i.getParameters())
+
+        if ctxt is None and len(target.getImportSpecs()) == 0 and target.getBody() is not None:
+            fn_m = self._fn_m
+            def call_body(root, env):
+                fn = fn_m.get(name, None)
+                if fn is None:
+                    fn = self.build(target.getBody(), len(arg_l))
+                    fn_m[name] = fn
+                fn(root, [a(root, env) for a in arg_l])
+                return 0
+            return call_body
+
+        if self._call is None:
+            raise Exception("Function %s has no body, and no call handler was provided" % name)
+        call = self._call
+        ctxt_f = self._buildCtxt(ctxt)
+
+        def call_ext(root, env):
+            ret = call(name, ctxt_f(root, env), [a(root, env) for a in arg_l])
+            return 0 if ret is None else ret
+        return call_ext
+
+    def _buildCtxt(self, ctxt):
+        """Returns a callable that resolves the context of a call"""
+        if ctxt is None:
+            return lambda root, env: None
+        index = None
+        if isinstance(ctxt, TypeExprArrIndex):
+            index = self._build(ctxt.getIndexExpr())
+            ctxt = ctxt.getRootExpr()
+        path = self._fieldPath(ctxt)
+
+        def field(root):
+            f = root
+            for p in path:
+                f = f.getField(p)
+            return f
+        if index is None:
+            return lambda root, env: field(root)
+        else:
+            return lambda root, env: (field(root), index(root, env))
+
+    def _localRef(self, ref):
+        """Resolves bottom-up references to procedural variables, as
+        (scope index, variable index)"""
+        if not isinstance(ref, vsc_ctxt.TypeExprFieldRef):
+            return None
+        if ref.getRootRefKind() != vsc_ctxt.TypeExprFieldRefKind.BottomUpScope:
+            return None
+        off = ref.getRootRefOffset()
+        if off >= self._depth or ref.size() < 1:
+            return None
+        return (self._depth-1-off, ref.at(0))
+
+    def _fieldPath(self, ref):
+        if ref.getRootRefKind() != vsc_ctxt.TypeExprFieldRefKind.TopDownScope or ref.getRootRefOffset() != 0:
+            raise Exception("Unsupported field reference (kind %s, offset %d)" % (
+                str(ref.getRootRefKind()), ref.getRootRefOffset()))
+        return tuple(ref.at(ii) for ii in range(ref.size()))
@@ -25,6 +25,9 @@ from .type_info import TypeInfo
 from .exec_type import ExecType
 from .typeinfo_extend_base import TypeInfoExtendBase
 from vsc_dataclasses.impl import ExtendRandClassDecoratorImpl
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 class ExtendBaseDecoratorImpl(ExtendRandClassDecoratorImpl):
 
@@ -37,8 +40,9 @@ class ExtendBaseDecoratorImpl(ExtendRandClassDecoratorImpl):
 
         # collect exec blocks registers in this scope
         for exec_ti in typeworks.DeclRgy.pop_decl(ExecType, typeworks.scopename(T)):
-            print("Add exec block %s %s" % (str(exec_ti), str(T)))
-            print("  annotations: %s" % str(exec_ti.func.__annotations__))
+            if _dbg.en:
+                _dbg.debug("Add exec block %s %s" % (str(exec_ti), str(T)))
+                _dbg.debug("  annotations: %s" % str(exec_ti.func.__annotations__))
             typeinfo_ti.addExec(exec_ti)
         
         # Now, link up the 'super' relationships
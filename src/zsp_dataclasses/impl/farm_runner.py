@@ -0,0 +1,284 @@
+#****************************************************************************
+#* farm_runner.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import itertools
+import multiprocessing
+import os
+import threading
+import time
+import traceback
+from multiprocessing.connection import Client, Listener, wait
+from .eval_listener import EvalListener
+from .model_eval_batch import ModelEvalBatch
+from .debug import Debug
+
+_dbg = Debug.get("farm")
+
+class FarmResult(object):
+    """Outcome of evaluating one (action, seed) work item. 'data' holds 
+    the value returned by the runner's 'collect' callback (eg coverage)"""
+    __slots__ = ("idx", "action", "seed", "ok", "error", "wall", "n_actions", "data", "worker")
+
+    def __init__(self, idx, action, seed, worker=None):
+        self.idx = idx
+        self.action = action
+        self.seed = seed
+        self.ok = False
+        self.error = None
+        self.wall = 0.0
+        self.n_actions = 0
+        self.data = None
+        self.worker = worker
+
+    def __repr__(self):
+        return "FarmResult(%d, %s, seed=%s, ok=%s)" % (
+            self.idx, self.action, str(self.seed), str(self.ok))
+
+class _ActionCounter(EvalListener):
+
+    def __init__(self):
+        self._lock = threading.Lock()
+        self.n = 0
+
+    def action(self, action, t_start, t_end, cpu):
+        with self._lock:
+            self.n += 1
+
+class FarmWorker(object):
+    """Evaluates work items against an elaborated root component. Work 
+    items name their root action by qualified name, such that workers in
+    other processes (or on other hosts) can resolve them"""
+
+    def __init__(self, root, actions, collect=None, batch_sz=ModelEvalBatch.DEFAULT_BATCH_SZ):
+        self.root = root
+        self.action_m = {}
+        for a in actions:
+            self.action_m[a.__qualname__] = a
+        self.collect = collect
+        self.batch_sz = batch_sz
+        self.name = "%s:%d" % (os.uname().nodename, os.getpid())
+        self._counter = _ActionCounter()
+        root.addEvalListener(self._counter)
+
+    def evalOne(self, idx, action_n, seed) -> FarmResult:
+        ret = FarmResult(idx, action_n, seed, self.name)
+        n_actions = self._counter.n
+        t_start = time.perf_counter()
+        try:
+            action_t = self.action_m.get(action_n, None)
+            if action_t is None:
+                raise Exception("Action %s is not known to worker %s" % (action_n, self.name))
+            asyncio.run(self.root.eval(action_t, self.batch_sz, seed))
+            if self.collect is not None:
+                ret.data = self.collect(self.root, action_t, seed)
+            ret.ok = True
+        except Exception:
+            ret.error = traceback.format_exc()
+        ret.wall = time.perf_counter() - t_start
+        ret.n_actions = self._counter.n - n_actions
+        return ret
+
+    def serve(self, conn):
+        """Evaluates chunks of work received on 'conn' until told to stop"""
+        conn.send(("ready", self.name))
+        while True:
+            msg = conn.recv()
+            if msg[0] == "stop":
+                break
+            res_l = []
+            for idx,action_n,seed in msg[1]:
+                res_l.append(self.evalOne(idx, action_n, seed))
+            conn.send(("done", res_l))
+
+    def connect(self, address, authkey, timeout=30.0):
+        """Serves a FarmRunner listening on 'address'. Retries for up to
+        'timeout' seconds while the runner is not yet listening"""
+        t_end = time.monotonic() + timeout
+        while True:
+            try:
+                conn = Client(address, authkey=authkey)
+                break
+            except ConnectionRefusedError:
+                if time.monotonic() >= t_end:
+                    raise
+                time.sleep(0.1)
+        try:
+            self.serve(conn)
+        finally:
+            conn.close()
+
+def _fork_main(worker, conn):
+    worker.name = "%s:%d" % (os.uname().nodename, os.getpid())
+    try:
+        worker.serve(conn)
+    except EOFError:
+        # The runner went away
+        pass
+    finally:
+        conn.close()
+
+class FarmRunner(object):
+    """Evaluates many (root action, seed) pairs against a root component
+    that is elaborated once. Local workers are forked from the current
+    process, and so share the elaborated model copy-on-write. Workers on
+    other hosts connect to 'address' (see FarmWorker.connect). 
+
+    Work is handed out in chunks of 'chunk_sz' items, and results are
+    yielded as they arrive, in completion order. When no worker is
+    connected for 'worker_timeout' seconds while work remains, run()
+    raises. None waits indefinitely.
+
+    Messages are pickles, and unpickling can run arbitrary code. Remote
+    workers must therefore authenticate with 'authkey', which is
+    required whenever 'address' is set. The key authenticates peers but
+    doesn't encrypt traffic, so only listen on trusted networks"""
+
+    def __init__(self, 
+                 root, 
+                 actions,
+                 n_workers=None,
+                 collect=None,
+                 chunk_sz=16,
+                 batch_sz=ModelEvalBatch.DEFAULT_BATCH_SZ,
+                 address=None,
+                 authkey=None,
+                 worker_timeout=60.0):
+        if address is not None and not authkey:
+            raise Exception("FarmRunner requires an authkey when accepting remote workers")
+        self._worker = FarmWorker(root, actions, collect, batch_sz)
+        self._n_workers = os.cpu_count() if n_workers is None else n_workers
+        if self._n_workers == 0 and address is None:
+            raise Exception("FarmRunner requires local workers, remote workers, or both")
+        if chunk_sz < 1:
+            raise Exception("chunk_sz must be at least 1 (%d)" % chunk_sz)
+        self._chunk_sz = chunk_sz
+        self._address = address
+        self._authkey = authkey
+        self._worker_timeout = worker_timeout
+
+    def run(self, work):
+        """Evaluates 'work', an iterable of (action type, seed) pairs. 
+        Returns an iterator over FarmResult, whose 'idx' is the position
+        of the item in 'work'"""
+        work_it = enumerate(work)
+        conn_m = {}
+        proc_l = []
+        accept_l = []
+        listener = None
+
+        def next_chunk():
+            ret = []
+            for idx,(action_t,seed) in itertools.islice(work_it, self._chunk_sz):
+                ret.append((idx, action_t.__qualname__, seed))
+            return ret
+
+        try:
+            if self._n_workers > 0:
+                mp_ctxt = multiprocessing.get_context("fork")
+                for _ in range(self._n_workers):
+                    conn, child_conn = mp_ctxt.Pipe()
+                    p = mp_ctxt.Process(target=_fork_main, args=(self._worker, child_conn))
+                    p.start()
+                    child_conn.close()
+                    proc_l.append(p)
+                    conn_m[conn] = None
+
+            if self._address is not None:
+                listener = Listener(self._address, authkey=self._authkey)
+                threading.Thread(
+                    target=FarmRunner._accept, 
+                    args=(listener, accept_l), 
+                    daemon=True).start()
+
+            done = False
+            t_idle = None
+            while True:
+                while len(accept_l) > 0:
+                    conn_m[accept_l.pop()] = None
+                if done and len(conn_m) == 0:
+                    break
+
+                if len(conn_m) > 0:
+                    t_idle = None
+                elif listener is None:
+                    # All local workers exited, and none can connect
+                    raise Exception("All farm workers exited with work remaining")
+                elif t_idle is None:
+                    t_idle = time.monotonic()
+                elif (self._worker_timeout is not None and 
+                        time.monotonic() - t_idle >= self._worker_timeout):
+                    raise Exception("No farm workers connected within %.1fs" % self._worker_timeout)
+
+                ready = wait(
+                    list(conn_m.keys()), 
+                    timeout=(0.1 if listener is not None else None))
+                for conn in ready:
+                    try:
+                        msg = conn.recv()
+                    except EOFError:
+                        # The worker exited. Its current chunk fails
+                        for idx,action_n,seed in (conn_m.pop(conn) or []):
+                            r = FarmResult(idx, action_n, seed)
+                            r.error = "Worker exited before completing the item"
+                            yield r
+                        conn.close()
+                        continue
+
+                    if msg[0] == "ready":
+                        if _dbg.en:
+                            _dbg.debug("Worker %s ready" % msg[1])
+                    else:
+                        for r in msg[1]:
+                            yield r
+
+                    chunk = next_chunk() if not done else []
+                    if len(chunk) > 0:
+                        conn.send(("work", chunk))
+                        conn_m[conn] = chunk
+                    else:
+                        done = True
+                        conn.send(("stop",))
+                        conn_m.pop(conn)
+                        conn.close()
+        finally:
+            if listener is not None:
+                listener.close()
+            for conn in conn_m.keys():
+                conn.close()
+            for p in proc_l:
+                p.join(timeout=(None if len(conn_m) == 0 else 1.0))
+                if p.is_alive():
+                    p.terminate()
+                    p.join()
+
+    @staticmethod
+    def _accept(listener, accept_l):
+        while True:
+            try:
+                accept_l.append(listener.accept())
+            except OSError:
+                # The listener was closed
+                break
+            except Exception as e:
+                # Eg a failed authentication. Keep accepting
+                if _dbg.en:
+                    _dbg.debug("Rejected worker connection: %s" % str(e))
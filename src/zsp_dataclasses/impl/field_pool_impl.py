@@ -7,6 +7,9 @@ Created on May 12, 2022
 import vsc_dataclasses.impl as vsc_impl
 from .ctor import Ctor
 from .struct_kind_e import StructKindE
+from .debug import Debug
+
+_dbg = Debug.get("pool")
 
 class FieldPoolImpl(vsc_impl.FieldBaseImpl):
     
@@ -31,5 +34,6 @@ class FieldPoolImpl(vsc_impl.FieldBaseImpl):
             if self._modelinfo._typeinfo._kind != StructKindE.Resource:
                 raise Exception("Size can only be specified on resource pools. Pool %s is of kind %s" % (
                     self._modelinfo.name, self._modelinfo._typeinfo._kind))
-            print("Set value to %d" % v)
+            if _dbg.en:
+                _dbg.debug("Set value to %d" % v)
             self._modelinfo.libobj.getField(0).val().set_val_i(v)
@@ -0,0 +1,65 @@
+#****************************************************************************
+#* field_reg_array_impl.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+from .field_reg_c_impl import FieldRegCImpl
+
+class FieldRegArrayImpl(object):
+    """Register array. The array is a single type field, and element
+    facades are created on access, such that the cost of an array does
+    not depend on its length. Element references index the array field
+    (TypeExprArrIndex)"""
+
+    def __init__(self, modelinfo_p, name, idx, reg_t, count):
+        self._modelinfo_p = modelinfo_p
+        self._name = name
+        self._idx = idx
+        self._reg_t = reg_t
+        self._count = count
+        self._path = None
+
+    def __len__(self):
+        return self._count
+
+    def __getitem__(self, i):
+        if not isinstance(i, int):
+            raise Exception("Register array %s only supports constant indices" % self._name)
+        if i < 0:
+            i += self._count
+        if i < 0 or i >= self._count:
+            raise Exception("Index %d out of range for register array %s[%d]" % (
+                i, self._name, self._count))
+
+        if self._path is None:
+            self._path = FieldRegCImpl.refPath(self._modelinfo_p) + (self._idx,)
+
+        elem = FieldRegCImpl(
+            self._modelinfo_p,
+            "%s[%d]" % (self._name, i),
+            self._idx,
+            self._reg_t,
+            i)
+        elem._path = self._path
+        return elem
+
+    def __iter__(self):
+        for i in range(self._count):
+            yield self[i]
+
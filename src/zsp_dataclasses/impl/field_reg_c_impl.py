@@ -23,18 +23,36 @@ from vsc_dataclasses.impl.ctor import Ctor as VscCtor
 import vsc_dataclasses.impl.context as vsc_ctxt
 from vsc_dataclasses.impl.expr import Expr
 from .ctor import Ctor
+from .debug import Debug
+
+_dbg = Debug.get("reg")
+
+_reg_read = Ctor.sym("pss::core::reg_read")
+_reg_write = Ctor.sym("pss::core::reg_write")
+_reg_read_val = Ctor.sym("pss::core::reg_read_val")
+_reg_write_val = Ctor.sym("pss::core::reg_write_val")
+_reg_write_block = Ctor.sym("pss::core::reg_write_block")
+_reg_read_block = Ctor.sym("pss::core::reg_read_block")
+_reg_modify = Ctor.sym("pss::core::reg_modify")
 
 class FieldRegCImpl(object):
 
-    def __init__(self, modelinfo_p, name, idx):
+    def __init__(self, modelinfo_p, name, idx, reg_t=None, elem_idx=None):
         self._modelinfo_p = modelinfo_p
         self._name = name
         self._idx = idx
+        # Element index, when this is an element of register array 'idx'
+        self._elem_idx = elem_idx
+        # Library type of the register value
+        self._reg_t = reg_t
+        # Offset path from the root component. Resolved on first use, 
+        # since parent indices are assigned after construction
+        self._path = None
         pass
 
     def read(self):
         ctor = Ctor.inst()
-        reg_read = ctor.ctxt().findDataTypeFunction("pss::core::reg_read")
+        reg_read = ctor.core_fn(_reg_read)
 
         call_expr = ctor.ctxt().mkTypeExprMethodCallContext(
             reg_read,
@@ -46,7 +64,7 @@ class FieldRegCImpl(object):
         ctor = Ctor.inst()
         vsc_ctor = VscCtor.inst()
 
-        reg_write = Ctor.inst().ctxt().findDataTypeFunction("pss::core::reg_write")
+        reg_write = ctor.core_fn(_reg_write)
         value_e = Expr.toExpr(value)
         value_e = vsc_ctor.pop_expr(value_e)
 
@@ -57,7 +75,7 @@ class FieldRegCImpl(object):
 
     def read_val(self):
         ctor = Ctor.inst()
-        reg_read_val = Ctor.inst().ctxt().findDataTypeFunction("pss::core::reg_read_val")
+        reg_read_val = ctor.core_fn(_reg_read_val)
         return Expr(ctor.ctxt().mkTypeExprMethodCallContext(
                     reg_read_val,
                     self.mkRef(),
@@ -65,14 +83,74 @@ class FieldRegCImpl(object):
 
     def write_val(self, value):
         ctor = Ctor.inst()
-        reg_write_val = Ctor.inst().ctxt().findDataTypeFunction("pss::core::reg_write_val")
-        ctor.proc_scope().addStatement(
-            ctor.ctxt().mkTypeProcStmtExpr(
-                ctor.ctxt().mkTypeExprMethodCallContext(
+        vsc_ctor = VscCtor.inst()
+
+        reg_write_val = ctor.core_fn(_reg_write_val)
+        value_e = Expr.toExpr(value)
+        value_e = vsc_ctor.pop_expr(value_e)
+
+        return Expr(ctor.ctxt().mkTypeExprMethodCallContext(
                     reg_write_val,
                     self.mkRef(),
-                    [])))
-        pass
+                    [value_e]))
+
+    def write_block(self, values):
+        """Writes 'values' to consecutive registers, starting with this
+        one, as a single (burst) access"""
+        ctor = Ctor.inst()
+        if len(values) == 0:
+            raise Exception("write_block of %s requires at least one value" % self._name)
+        reg_write_block = ctor.core_fn(_reg_write_block)
+        return Expr(ctor.ctxt().mkTypeExprMethodCallContext(
+                    reg_write_block,
+                    self.mkRef(),
+                    self._popExprs(values)))
+
+    def read_block(self, dests):
+        """Reads consecutive registers, starting with this one, into the
+        fields or variables in 'dests' as a single (burst) access"""
+        ctor = Ctor.inst()
+        if len(dests) == 0:
+            raise Exception("read_block of %s requires at least one destination" % self._name)
+        reg_read_block = ctor.core_fn(_reg_read_block)
+        return Expr(ctor.ctxt().mkTypeExprMethodCallContext(
+                    reg_read_block,
+                    self.mkRef(),
+                    self._popExprs(dests)))
+
+    def modify(self, **kwargs):
+        """Updates the named register fields with a single read-modify-write
+        access. Parameters are (field index, value) pairs, leaving the
+        target to form the mask from the register layout"""
+        ctor = Ctor.inst()
+        if len(kwargs) == 0:
+            raise Exception("modify of %s requires at least one field" % self._name)
+        reg_modify = ctor.core_fn(_reg_modify)
+
+        params = []
+        for name,value in kwargs.items():
+            params.append(self._fieldIdx(name))
+            params.append(value)
+
+        return Expr(ctor.ctxt().mkTypeExprMethodCallContext(
+                    reg_modify,
+                    self.mkRef(),
+                    self._popExprs(params)))
+
+    def _fieldIdx(self, name):
+        if self._reg_t is None:
+            raise Exception("Register %s has no type information" % self._name)
+        for i,f in enumerate(self._reg_t.getFields()):
+            if f.name() == name:
+                return i
+        raise Exception("Register %s has no field %s" % (self._name, name))
+
+    def _popExprs(self, values):
+        vsc_ctor = VscCtor.inst()
+        ret = []
+        for v in values:
+            ret.append(vsc_ctor.pop_expr(Expr.toExpr(v)))
+        return ret
 
     def mkRef(self):
         ctor = Ctor.inst()
@@ -81,19 +159,38 @@ class FieldRegCImpl(object):
         kind = vsc_ctxt.TypeExprFieldRefKind.TopDownScope
         root_off = 0
 
-        mi = self._modelinfo_p
-
-        offset_l = [self._idx]
-        while mi is not None and mi._idx != -1:
-            print("MI: %s %d %s" % (str(mi), mi._idx, mi._name))
-            offset_l.insert(0, mi._idx)
-            mi = mi._parent
-
-
-        return ctor.ctxt().mkTypeExprFieldRef(
+        # Each reference is a distinct expression node, but all share
+        # the precomputed path
+        ref = ctor.ctxt().mkTypeExprFieldRef(
             kind,
             root_off,
-            offset_l
+            list(self.path())
         )
-
+        if self._elem_idx is not None:
+            # An element is an index into the array field. Extending the
+            # path instead would alias a sub-field of the register
+            ref = ctor.ctxt().mkTypeExprArrIndex(
+                ref,
+                self._popExprs([self._elem_idx])[0])
+        return ref
+
+    def path(self):
+        """Returns the offset path of the register, or of the array for
+        an array element"""
+        if self._path is None:
+            self._path = FieldRegCImpl.refPath(self._modelinfo_p) + (self._idx,)
+        return self._path
+
+    @staticmethod
+    def refPath(mi):
+        """Returns the offset path, from the root component, to the field
+        described by 'mi'"""
+        offset_l = []
+        while mi is not None and mi._idx != -1:
+            if _dbg.en:
+                _dbg.debug("MI: %s %d %s" % (str(mi), mi._idx, mi._name))
+            offset_l.append(mi._idx)
+            mi = mi._parent
+        offset_l.reverse()
+        return tuple(offset_l)
 
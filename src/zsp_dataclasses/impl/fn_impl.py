@@ -19,6 +19,9 @@
 #*     Author: 
 #*
 #****************************************************************************
+from .debug import Debug
+
+_dbg = Debug.get("fn")
 
 class FnImpl(object):
 
@@ -27,7 +30,8 @@ class FnImpl(object):
 
     @staticmethod
     def __call__(self, *args, **kwargs):
-        print("FnImpl: __call__")
+        if _dbg.en:
+            _dbg.debug("FnImpl: __call__")
 
     @classmethod
     def addMethods(cls, T):
@@ -19,15 +19,21 @@
 #*     Author: 
 #*
 #****************************************************************************
+import vsc_dataclasses.impl.context as vsc_ctxt
 from vsc_dataclasses.impl.generators.collect_struct_deps import CollectStructDeps
 from vsc_dataclasses.impl.pyctxt.data_type_struct import DataTypeStruct
-from zsp_dataclasses.impl.context import DataTypeAction, DataTypeComponent
+from zsp_dataclasses.impl.context import DataTypeAction, DataTypeArlStruct, DataTypeComponent
 from ..pyctxt.visitor_base import VisitorBase
 
 class CollectTypeDeps(VisitorBase,CollectStructDeps):
 
-    def __init__(self):
+    def __init__(self, dedup=False):
         CollectStructDeps.__init__(self, None)
+        # When enabled, struct types that are structurally identical
+        # to an earlier type are dropped from the result and recorded
+        # as aliases of that type
+        self._dedup = dedup
+        self._alias_m = {}
 
     def collect(self, root_comp, root_action):
         self._init()
@@ -37,8 +43,66 @@ class CollectTypeDeps(VisitorBase,CollectStructDeps):
         self.pop_scope()
         root_comp.accept(self)
         root_action.accept(self)
+
+        types = self._sort_deps()
+
+        if self._dedup:
+            types = self._dedupTypes(types)
         
-        return self._sort_deps()
+        return types
+
+    def aliases(self):
+        """Returns a map of id(type) -> canonical type for types removed
+        by de-duplication"""
+        return self._alias_m
+
+    def _dedupTypes(self, types):
+        self._alias_m = {}
+        key_m = {}
+        ret = []
+
+        # Types are sorted in dependency order, so the canonical type 
+        # of any field type is known before the type using it is keyed
+        for t in types:
+            key = self._structKey(t)
+            if key is not None:
+                if key in key_m.keys():
+                    self._alias_m[id(t)] = key_m[key]
+                    continue
+                key_m[key] = t
+            ret.append(t)
+        return ret
+
+    def _structKey(self, t):
+        """Computes a hashable key describing the layout of a struct type, 
+        ignoring its name. Returns None for types that must not be merged"""
+        if isinstance(t, (DataTypeAction, DataTypeComponent)):
+            return None
+        if not isinstance(t, DataTypeStruct):
+            return None
+        if len(t.getConstraints()) > 0:
+            return None
+        if isinstance(t, DataTypeArlStruct) and len(t.getExecs()) > 0:
+            return None
+
+        key = [type(t).__name__]
+        for f in t.getFields():
+            if isinstance(f, vsc_ctxt.TypeFieldPhy) and f.getInit() is not None:
+                return None
+            key.append((
+                type(f).__name__, 
+                f.name(), 
+                int(f.getAttr()),
+                self._dataTypeKey(f.getDataType())))
+        return tuple(key)
+
+    def _dataTypeKey(self, t):
+        if isinstance(t, vsc_ctxt.DataTypeInt):
+            return ("int", t.is_signed(), t.width())
+        elif id(t) in self._alias_m.keys():
+            return ("type", id(self._alias_m[id(t)]))
+        else:
+            return ("type", id(t))
 
     def visitDataTypeAction(self, i: DataTypeAction):
         if self.in_field():
@@ -0,0 +1,524 @@
+#****************************************************************************
+#* exec_cpp_gen.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import io
+import re
+import vsc_dataclasses.impl.context as vsc_ctxt
+from .output_buffered import OutputBuffered
+from ..context import DataTypeAction, DataTypeComponent, DataTypeFunction
+from ..context import DataTypeFunctionFlags, ExecKindT, TypeExec
+from ..context import TypeExprArrIndex, TypeExprMethodCallContext, TypeExprMethodCallStatic
+from ..context import TypeProcStmtAssign, TypeProcStmtAssignOp, TypeProcStmtExpr
+from ..context import TypeProcStmtIfElse, TypeProcStmtScope
+from ..pyctxt.visitor_base import VisitorBase
+from ..debug import Debug
+
+_dbg = Debug.get("gen")
+
+class ExecCppGen(VisitorBase):
+    """Lowers exec blocks and function bodies (TypeProcStmt* IR) to C++
+    functions, one per exec and per function with a body.
+
+    Generated functions have C linkage and the signature:
+        uint64_t f(zsp_exec_api_t *api, void *self, const uint64_t *args)
+
+    Values cross the API as uint64_t. Parameters, variables, and field
+    reads are converted to the width and signedness of their type, such
+    that comparisons and arithmetic follow the declared type. The output
+    compiles cleanly with -Wall -Wextra
+
+    Field accesses and calls to functions without a body (core-library,
+    import functions) are dispatched through the 'api' callback table,
+    which is provided by the evaluator that calls the function. The
+    generated source also exports a table of functions, and the names of
+    the functions that may be passed to api->call, such that a loader
+    can bind the entry points once"""
+
+    API_DECL = """\
+#include <stdint.h>
+#include <initializer_list>
+
+#ifndef INCLUDED_ZSP_EXEC_API_T
+#define INCLUDED_ZSP_EXEC_API_T
+typedef struct zsp_exec_api_s {
+    uint64_t (*read_field)(struct zsp_exec_api_s *api, void *self,
+        int32_t kind, int32_t offset, int32_t n, const int32_t *path);
+    void (*write_field)(struct zsp_exec_api_s *api, void *self,
+        int32_t kind, int32_t offset, int32_t n, const int32_t *path, uint64_t val);
+    uint64_t (*call)(struct zsp_exec_api_s *api, void *self, int32_t fn_id,
+        int32_t ctxt_kind, int32_t ctxt_offset, int32_t ctxt_n, const int32_t *ctxt_path,
+        int64_t ctxt_index, int32_t argc, const uint64_t *argv);
+    void *user;
+} zsp_exec_api_t;
+
+typedef uint64_t (*zsp_exec_f)(zsp_exec_api_t *api, void *self, const uint64_t *args);
+
+typedef struct zsp_exec_entry_s {
+    const char      *name;
+    zsp_exec_f      func;
+} zsp_exec_entry_t;
+#endif /* INCLUDED_ZSP_EXEC_API_T */
+"""
+
+    BINOP_M = {
+        "Eq" : "==", "Ne" : "!=", "Gt" : ">", "Ge" : ">=", "Lt" : "<", "Le" : "<=",
+        "Add" : "+", "Sub" : "-", "Mul" : "*", "Div" : "/", "Mod" : "%",
+        "BinAnd" : "&", "BinOr" : "|", "Xor" : "^", "BinXor" : "^",
+        "LogAnd" : "&&", "LogOr" : "||", "Sll" : "<<", "Srl" : ">>"
+    }
+
+    # Functions whose parameters are destinations. The callee writes
+    # results to argv[0..argc-1], which is a writable caller buffer
+    OUT_ARG_FN_S = set([
+        "pss::core::reg_read_block"
+    ])
+
+    EXEC_KIND_M = {
+        ExecKindT.Body : "body",
+        ExecKindT.InitDown : "init_down",
+        ExecKindT.InitUp : "init_up",
+        ExecKindT.PreSolve : "pre_solve",
+        ExecKindT.PostSolve : "post_solve"
+    }
+
+    def __init__(self, sink=None, chunk_sz=OutputBuffered.DEFAULT_CHUNK_SZ, prefix="zsp"):
+        super().__init__()
+        self._prefix = prefix
+        self._sink = sink
+        if sink is not None:
+            self._out = OutputBuffered(sink, chunk_sz)
+        else:
+            self._out = io.StringIO()
+        self._ind = ""
+        # Names of functions called through api->call, indexed by fn_id
+        self._call_fn_l = []
+        self._call_fn_m = {}
+        # (entry name, C function name) of generated functions
+        self._entry_l = []
+        self._fn_name_m = {}
+        self._type_s = []
+        self._scope_s = []
+        self._path_l = []
+        self._path_m = {}
+        self._expr = None
+        # Whether the function being lowered references api and self
+        self._uses_api = False
+        # Variables that are read, by C name
+        self._read_s = set()
+
+    def generate(self, types, functions=None):
+        """Generates C++ for the execs of 'types' (actions and components)
+        and for 'functions'. Returns the text, unless a sink was specified
+        when the generator was created"""
+        body = io.StringIO()
+        out = self._out
+        self._out = body
+
+        if functions is not None:
+            # Functions with a body are called directly. Register their
+            # names first, since bodies may call each other
+            for f in functions:
+                if self._hasBody(f):
+                    self._fn_name_m[f.name()] = "%s_fn_%s" % (
+                        self._prefix, self.identifier(f.name()))
+            for f in functions:
+                if self._hasBody(f):
+                    self.println("extern \"C\" uint64_t %s(zsp_exec_api_t *api, void *self, const uint64_t *args);" %
+                        self._fn_name_m[f.name()])
+            for f in functions:
+                if self._hasBody(f):
+                    f.accept(self)
+
+        for t in types:
+            t.accept(self)
+
+        self._out = out
+        self.write(ExecCppGen.API_DECL)
+        self.println("")
+        self.println("// Functions called by generated code via api->call, indexed by fn_id")
+        self.println("extern \"C\" const char *%s_exec_call_names[];" % self._prefix)
+        self.println("const char *%s_exec_call_names[] = {" % self._prefix)
+        self.inc_indent()
+        for n in self._call_fn_l:
+            self.println("\"%s\"," % n)
+        self.println("0")
+        self.dec_indent()
+        self.println("};")
+        self.println("")
+        for pn,path in enumerate(self._path_l):
+            self.println("static const int32_t path_%d[] = {%s};" % (
+                pn, ", ".join(str(p) for p in path)))
+        self.println("")
+        self.write(body.getvalue())
+        self.println("")
+        self.println("extern \"C\" const zsp_exec_entry_t %s_exec_entries[];" % self._prefix)
+        self.println("const zsp_exec_entry_t %s_exec_entries[] = {" % self._prefix)
+        self.inc_indent()
+        for name,fname in self._entry_l:
+            self.println("{\"%s\", &%s}," % (name, fname))
+        self.println("{0, 0}")
+        self.dec_indent()
+        self.println("};")
+
+        if self._sink is not None:
+            self._out.flush()
+            return None
+        else:
+            return self._out.getvalue()
+
+    @property
+    def entries(self):
+        """(name, C function name) for each generated function"""
+        return self._entry_l
+
+    @property
+    def call_names(self):
+        return self._call_fn_l
+
+    def visitDataTypeAction(self, i: DataTypeAction):
+        self._visitExecs(i)
+
+    def visitDataTypeComponent(self, i: DataTypeComponent):
+        self._visitExecs(i)
+
+    def visitDataTypeStruct(self, i):
+        if hasattr(i, "getExecs"):
+            self._visitExecs(i)
+
+    def _visitExecs(self, i):
+        self._type_s.append(i)
+        kind_n_m = {}
+        for e in i.getExecs():
+            kind = e.getKind()
+            idx = kind_n_m.get(kind, 0)
+            kind_n_m[kind] = idx+1
+            name = "%s::%s_%d" % (i.name(), ExecCppGen.EXEC_KIND_M[kind], idx)
+            fname = "%s_exec_%s" % (self._prefix, self.identifier(name))
+            self._entry_l.append((name, fname))
+            self._emitFunction(fname, e.getBody(), [])
+        self._type_s.pop()
+
+    def visitDataTypeFunction(self, i: DataTypeFunction):
+        fname = self._fn_name_m[i.name()]
+        self._entry_l.append((i.name(), fname))
+        self._emitFunction(fname, i.getBody(), i.getParameters())
+
+    def _emitFunction(self, fname, body, params):
+        if _dbg.en:
+            _dbg.debug("Lower %s" % fname)
+        self.println("extern \"C\" uint64_t %s(zsp_exec_api_t *api, void *self, const uint64_t *args) {" % fname)
+        self.inc_indent()
+
+        # The body is lowered first, since unused arguments and variables
+        # are only known afterwards
+        out = self._out
+        self._out = io.StringIO()
+        self._uses_api = False
+        self._read_s.clear()
+
+        # Parameters form the outer-most variable scope. They are copied
+        # to locals, such that the body may assign them
+        var_l = []
+        decl_l = []
+        for pi,p in enumerate(params):
+            vname = "p_%s" % self.identifier(p.name())
+            ctype = self._ctype(p.getDataType())
+            decl_l.append((vname, "%s %s = %s;" % (ctype, vname, self._conv(ctype, "args[%d]" % pi))))
+            var_l.append((vname, ctype))
+        self._scope_s.append(var_l)
+        body.accept(self)
+        self._scope_s.pop()
+        body_s = self._out.getvalue()
+        self._out = out
+
+        if not self._uses_api:
+            self.println("(void)api;")
+            self.println("(void)self;")
+        if len(params) == 0:
+            self.println("(void)args;")
+        self._emitDecls(decl_l)
+        self.write(body_s)
+        self.println("return 0;")
+        self.dec_indent()
+        self.println("}")
+        self.println("")
+
+    def _emitDecls(self, decl_l):
+        for vname,decl in decl_l:
+            self.println(decl)
+            if vname not in self._read_s:
+                self.println("(void)%s;" % vname)
+
+    def visitTypeExec(self, i: TypeExec):
+        i.getBody().accept(self)
+
+    def visitTypeProcStmtScope(self, i: TypeProcStmtScope):
+        self.println("{")
+        self.inc_indent()
+        var_l = []
+        decl_l = []
+        self._scope_s.append(var_l)
+        for v in i.getVariables():
+            vname = "v%d_%s" % (len(self._scope_s), self.identifier(v.name()))
+            ctype = self._ctype(v.getDataType())
+            if v.getInit() is not None:
+                init = self._conv(ctype, self._exprStr(v.getInit()))
+            else:
+                init = "0"
+            decl_l.append((vname, "%s %s = %s;" % (ctype, vname, init)))
+            var_l.append((vname, ctype))
+
+        out = self._out
+        self._out = io.StringIO()
+        for s in i.getStatements():
+            s.accept(self)
+        body_s = self._out.getvalue()
+        self._out = out
+
+        self._emitDecls(decl_l)
+        self.write(body_s)
+        self._scope_s.pop()
+        self.dec_indent()
+        self.println("}")
+
+    def visitTypeProcStmtAssign(self, i: TypeProcStmtAssign):
+        if i.op() != TypeProcStmtAssignOp.Eq:
+            raise Exception("Unsupported assignment operator %s" % str(i.op()))
+        rhs = self._exprStr(i.getRhs())
+        lhs = i.getLhs()
+        local = self._localRef(lhs)
+        if local is not None:
+            self.println("%s = %s;" % (local[0], self._conv(local[1], rhs)))
+        elif isinstance(lhs, vsc_ctxt.TypeExprFieldRef):
+            self.println("api->write_field(api, self, %s, %s);" % (self._refArgs(lhs), rhs))
+        else:
+            raise Exception("Unsupported assignment target %s" % str(lhs))
+
+    def visitTypeProcStmtExpr(self, i: TypeProcStmtExpr):
+        e = i.getExpr()
+        if isinstance(e, TypeExprMethodCallStatic) and e.getTarget().name() in ExecCppGen.OUT_ARG_FN_S:
+            self._outArgCall(e)
+        else:
+            self.println("%s;" % self._exprStr(e))
+
+    def _outArgCall(self, i):
+        """Calls a function whose parameters are destinations. The callee
+        fills the argument array, which is then stored to each destination"""
+        dst_l = list(i.getParameters())
+        buf = "ob_%d" % len(self._scope_s)
+        self.println("{")
+        self.inc_indent()
+        self.println("uint64_t %s[%d] = {0};" % (buf, len(dst_l)))
+        call = self._callStr(i, i.getContext() if isinstance(i, TypeExprMethodCallContext) else None, buf)
+        self.println("%s;" % call)
+        for ii,dst in enumerate(dst_l):
+            local = self._localRef(dst)
+            if local is not None:
+                self.println("%s = %s;" % (local[0], self._conv(local[1], "%s[%d]" % (buf, ii))))
+            elif isinstance(dst, vsc_ctxt.TypeExprFieldRef):
+                self.println("api->write_field(api, self, %s, %s[%d]);" % (self._refArgs(dst), buf, ii))
+            else:
+                raise Exception("Unsupported destination %s for %s" % (str(dst), i.getTarget().name()))
+        self.dec_indent()
+        self.println("}")
+
+    def visitTypeProcStmtIfElse(self, i: TypeProcStmtIfElse):
+        self.println("if (%s)" % self._exprStr(i.getCond()))
+        self._stmtBlock(i.getTrue())
+        if i.getFalse() is not None:
+            self.println("else")
+            self._stmtBlock(i.getFalse())
+
+    def _stmtBlock(self, s):
+        if isinstance(s, TypeProcStmtScope):
+            s.accept(self)
+        else:
+            self.println("{")
+            self.inc_indent()
+            s.accept(self)
+            self.dec_indent()
+            self.println("}")
+
+    def visitTypeExprBin(self, i):
+        op = i.op()
+        name = op.name if hasattr(op, "name") else str(op)
+        if name not in ExecCppGen.BINOP_M.keys():
+            raise Exception("Unsupported binary operator %s" % name)
+        self._expr = "(%s %s %s)" % (
+            self._exprStr(i.lhs()),
+            ExecCppGen.BINOP_M[name],
+            self._exprStr(i.rhs()))
+
+    def visitTypeExprVal(self, i):
+        # Constants are signed unless out of range, such that comparing
+        # with a signed value doesn't convert it to unsigned
+        v = i.val().val_i()
+        if v < (1 << 63):
+            self._expr = "INT64_C(%d)" % v
+        else:
+            self._expr = "UINT64_C(%d)" % (v & 0xFFFFFFFFFFFFFFFF)
+
+    def visitTypeExprFieldRef(self, i):
+        local = self._localRef(i)
+        if local is not None:
+            self._read_s.add(local[0])
+            self._expr = local[0]
+        else:
+            self._expr = self._conv(
+                self._ctype(self._fieldType(i)),
+                "api->read_field(api, self, %s)" % self._refArgs(i))
+
+    def visitTypeExprMethodCallStatic(self, i: TypeExprMethodCallStatic):
+        self._expr = self._callStr(i, None)
+
+    def visitTypeExprMethodCallContext(self, i: TypeExprMethodCallContext):
+        self._expr = self._callStr(i, i.getContext())
+
+    def _callStr(self, i, ctxt, argv=None):
+        self._uses_api = True
+        target = i.getTarget()
+        if argv is not None:
+            # Caller-provided argument buffer
+            args = list(i.getParameters())
+        else:
+            args = list(map(lambda p: self._exprStr(p), i.getParameters()))
+            if len(args) > 0:
+                # The backing array lives until the end of the full expression
+                argv = "std::initializer_list<uint64_t>{%s}.begin()" % ", ".join(args)
+            else:
+                argv = "0"
+
+        if ctxt is None and target.name() in self._fn_name_m.keys():
+            # Functions with a body are called directly
+            return "%s(api, self, %s)" % (self._fn_name_m[target.name()], argv)
+
+        if target.name() not in self._call_fn_m.keys():
+            self._call_fn_m[target.name()] = len(self._call_fn_l)
+            self._call_fn_l.append(target.name())
+        fn_id = self._call_fn_m[target.name()]
+
+        # Array elements (eg of a register array) pass the array reference
+        # and the element index. Other contexts pass an index of -1
+        if isinstance(ctxt, TypeExprArrIndex):
+            ctxt_args = "%s, (int64_t)(%s)" % (
+                self._refArgs(ctxt.getRootExpr()),
+                self._exprStr(ctxt.getIndexExpr()))
+        elif ctxt is not None:
+            ctxt_args = "%s, -1" % self._refArgs(ctxt)
+        else:
+            ctxt_args = "0, 0, 0, 0, -1"
+        return "api->call(api, self, %d /* %s */, %s, %d, %s)" % (
+            fn_id, target.name(), ctxt_args, len(args), argv)
+
+    def _localRef(self, ref):
+        """Resolves bottom-up references to procedural variables. The root
+        offset selects the scope (0 is the inner-most), and the first path
+        element selects the variable. Returns (C name, C type)"""
+        if not isinstance(ref, vsc_ctxt.TypeExprFieldRef):
+            return None
+        if ref.getRootRefKind() != vsc_ctxt.TypeExprFieldRefKind.BottomUpScope:
+            return None
+        off = ref.getRootRefOffset()
+        if off >= len(self._scope_s) or ref.size() < 1:
+            return None
+        var_l = self._scope_s[-(off+1)]
+        if ref.at(0) >= len(var_l):
+            return None
+        return var_l[ref.at(0)]
+
+    def _fieldType(self, ref):
+        """Returns the data type of a field of the current type, or None
+        when the reference can't be resolved here"""
+        if (len(self._type_s) == 0 or 
+                ref.getRootRefKind() != vsc_ctxt.TypeExprFieldRefKind.TopDownScope or
+                ref.getRootRefOffset() != 0):
+            return None
+        t = self._type_s[-1]
+        for ii in range(ref.size()):
+            if not hasattr(t, "getFields"):
+                return None
+            field_l = t.getFields()
+            if ref.at(ii) >= len(field_l):
+                return None
+            t = field_l[ref.at(ii)].getDataType()
+        return t
+
+    @staticmethod
+    def _ctype(t):
+        """Returns the C type holding values of data type 't'"""
+        if not isinstance(t, vsc_ctxt.DataTypeInt):
+            return "uint64_t"
+        width = 8
+        while width < t.width() and width < 64:
+            width *= 2
+        return "%sint%d_t" % ("" if t.is_signed() else "u", width)
+
+    @staticmethod
+    def _conv(ctype, expr):
+        if ctype == "uint64_t":
+            return expr
+        return "(%s)(%s)" % (ctype, expr)
+
+    def _refArgs(self, ref):
+        self._uses_api = True
+        path = tuple(ref.at(ii) for ii in range(ref.size()))
+        if len(path) == 0:
+            # Zero-length arrays aren't valid C++
+            return "%d, %d, 0, 0" % (int(ref.getRootRefKind()), ref.getRootRefOffset())
+        if path not in self._path_m.keys():
+            self._path_m[path] = len(self._path_l)
+            self._path_l.append(path)
+        pn = self._path_m[path]
+        return "%d, %d, %d, path_%d" % (
+            int(ref.getRootRefKind()),
+            ref.getRootRefOffset(),
+            len(path),
+            pn)
+
+    def _exprStr(self, e):
+        self._expr = None
+        e.accept(self)
+        if self._expr is None:
+            raise Exception("Unsupported expression %s" % str(e))
+        ret = self._expr
+        self._expr = None
+        return ret
+
+    def _hasBody(self, f):
+        return (len(f.getImportSpecs()) == 0
+                and not f.hasFlags(DataTypeFunctionFlags.Core)
+                and f.getBody() is not None)
+
+    def println(self, s):
+        self._out.write(self._ind + s + "\n")
+
+    def write(self, s):
+        self._out.write(s)
+
+    def inc_indent(self):
+        self._ind += "    "
+
+    def dec_indent(self):
+        self._ind = self._ind[:-4]
+
+    def identifier(self, name):
+        return re.sub(r'[^A-Za-z0-9_]', '_', name)
+
@@ -0,0 +1,64 @@
+#****************************************************************************
+#* output_buffered.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+
+class OutputBuffered(object):
+    """Stream-like object that replaces the generator's StringIO. Text is
+    accumulated in a bounded buffer and forwarded to the sink (any object
+    with a 'write' method: file, pipe, socket wrapper) in chunks, so the
+    complete generated text is never held in memory"""
+
+    DEFAULT_CHUNK_SZ = 64*1024
+
+    def __init__(self, sink, chunk_sz=DEFAULT_CHUNK_SZ, encoding=None):
+        self._sink = sink
+        self._chunk_sz = chunk_sz
+        self._encoding = encoding
+        self._buf = []
+        self._buf_sz = 0
+        self._total_sz = 0
+
+    def write(self, s):
+        self._buf.append(s)
+        self._buf_sz += len(s)
+        if self._buf_sz >= self._chunk_sz:
+            self.flush()
+
+    def flush(self):
+        if self._buf_sz > 0:
+            chunk = "".join(self._buf)
+            if self._encoding is not None:
+                # Binary sinks (eg a compiler's stdin pipe)
+                self._sink.write(chunk.encode(self._encoding))
+            else:
+                self._sink.write(chunk)
+            self._total_sz += self._buf_sz
+            self._buf.clear()
+            self._buf_sz = 0
+
+    @property
+    def total_sz(self):
+        """Number of characters written so far"""
+        return self._total_sz + self._buf_sz
+
+    def getvalue(self):
+        raise Exception("Generated text is streamed to the sink and is not retained")
+
@@ -20,80 +20,97 @@
 #*
 #****************************************************************************
 
+import io
+import multiprocessing
 import zsp_dataclasses.impl.context as ctxt_api
 from vsc_dataclasses.impl.generators.vsc_data_model_cpp_gen import VscDataModelCppGen
 from vsc_dataclasses.impl.pyctxt.data_type_struct import DataTypeStruct
 from .collect_type_deps import CollectTypeDeps
+from .output_buffered import OutputBuffered
 from ..context import DataTypeAction, DataTypeComponent, DataTypeFunction, TypeExec, TypeExprMethodCallContext, TypeExprMethodCallStatic, TypeFieldReg, TypeFieldRegGroup, TypeProcStmtExpr, TypeProcStmtIfElse, TypeProcStmtScope
 from ..context import DataTypeFunctionFlags, TypeProcStmtAssign, TypeProcStmtAssignOp
+from ..context import TypeExprArrIndex
 from ..pyctxt.visitor_base import VisitorBase
+from ..debug import Debug
+
+_dbg = Debug.get("gen")
+
+# Generator whose parts are produced by forked workers (see generateSplit)
+_split_gen = None
+
+def _gen_part(args):
+    return _split_gen._genPart(*args)
 
 class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
 
-    def __init__(self):
+    def __init__(self, 
+                 sink=None, 
+                 chunk_sz=OutputBuffered.DEFAULT_CHUNK_SZ,
+                 reg_tables=False,
+                 dedup_types=False):
         VscDataModelCppGen.__init__(self)
         self._define_func = False
+
+        # When enabled, structurally-identical struct types are emitted
+        # once, and references to duplicates refer to the shared type
+        self._dedup_types = dedup_types
+        self._type_alias_m = {}
+
+        # Handles of the types and functions being generated. Generated 
+        # code resolves each once into a table, and refers to the table
+        # entry rather than looking it up by name at each use
+        self._comp_h_m = {}
+        self._action_h_m = {}
+        self._func_h_m = {}
+        # Prefix of the table names. generate() prefixes the tables with
+        # the root component, such that the tables of several models can
+        # be defined in one scope
+        self._tbl_pref = ""
+
+        # Inputs of the part being generated by generateSplit
+        self._split_types = []
+        self._split_functions = []
+        self._split_extra_types = None
+
+        # When enabled, runs of register fields are emitted as a static
+        # table and a single construction loop, rather than as one
+        # builder-call sequence per register
+        self._reg_tables = reg_tables
+
+        # When a sink is specified, output is streamed to it in bounded
+        # chunks rather than being collected in a string
+        self._sink = sink
+        if sink is not None:
+            self._out = OutputBuffered(sink, chunk_sz)
         pass
 
     def generate(self, 
                  root_comp : DataTypeComponent, 
                  root_action : DataTypeAction,
-                 functions,
+                 functions=None,
                  extra_types=None):
+        """Generates C++ to construct the data model. Returns the text,
+        unless a sink was specified when the generator was created"""
+        types = self._collect(root_comp, root_action)
+        self._tbl_pref = "%s_" % self.leaf_name(root_comp.name())
+
+        if len(self._comp_h_m) > 0:
+            self.println("static zsp::arl::dm::IDataTypeComponent *%s[%d] = {};" % (
+                self._tbl("comp_types"), len(self._comp_h_m)))
+        if len(self._action_h_m) > 0:
+            self.println("static zsp::arl::dm::IDataTypeAction *%s[%d] = {};" % (
+                self._tbl("action_types"), len(self._action_h_m)))
+
         # TODO: likely need both root component and action type
         if functions is not None and len(functions) > 0:
-            # First, declare all functions
-            self._define_func = False
-            for f in functions:
-#                if f.hasFlags(DataTypeFunctionFlags.Core):
-#                    continue
+            self.println("static zsp::arl::dm::IDataTypeFunction *%s[%d] = {};" % (
+                self._tbl("functions"), len(functions)))
+            self._genFunctions(functions)
 
-                self.println("{")
-                self.inc_indent()
-                f.accept(self)
-                self.dec_indent()
-                self.println("}")
-            self._define_func = True
-            for f in functions:
-                if f.hasFlags(DataTypeFunctionFlags.Core):
-                    continue
+        self._genExtraTypes(extra_types)
 
-                self.println("{")
-                self.inc_indent()
-                self.println("zsp::arl::dm::IDataTypeFunction *%s_t = %s->findDataTypeFunction(\"%s\");" % (
-                    self.identifier(f.name()),
-                    self._ctxt,
-                    f.name()))
-                if len(f.getImportSpecs()) > 0:
-                    self.println("%s_t->addImportSpec(" % ( self.identifier(f.name())))
-                    self.inc_indent()
-                    self.println("%s->mkDataTypeFunctionImport(\"%s\", false, false)" % (
-                        self._ctxt,
-                        "X",
-                    ))
-                    self.dec_indent()
-                    self.println(");")
-                else:
-                    self.println("%s_t->setBody(" % f.name())
-                    self.inc_indent()
-                    f.getBody().accept(self)
-                    self.dec_indent()
-                    self.println(");")
-                self.dec_indent()
-                self.println("}")
-
-        if extra_types is not None:
-            for et in extra_types:
-                print("ET: %s" % str(et))
-                self.println("{")
-                self.inc_indent()
-                et.accept(self)
-                self.dec_indent()
-                self.println("}")
-
-        types = CollectTypeDeps().collect(root_comp, root_action)
-
-        print("types: %s" % str(types))
+        if _dbg.en:
+            _dbg.debug("types: %s" % str(types))
         for t in types:
             t.accept(self)
 
@@ -104,24 +121,278 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
         # self.dec_indent()
         # self.println("}")
         self.println("")
-        self.println("zsp::arl::dm::IDataTypeComponent *%s_t = %s->findDataTypeComponent(\"%s\");" % (
+        self.println("zsp::arl::dm::IDataTypeComponent *%s_t = %s;" % (
             self.leaf_name(root_comp.name()),
-            self._ctxt,
-            root_comp.name()))
-        self.println("zsp::arl::dm::IDataTypeAction *%s_t = %s->findDataTypeAction(\"%s\");" % (
+            self._compRef(root_comp)))
+        self.println("zsp::arl::dm::IDataTypeAction *%s_t = %s;" % (
             self.leaf_name(root_action.name()),
-            self._ctxt,
-            root_action.name()))
+            self._actionRef(root_action)))
 
         # TODO: find RootAction handle
 
-        return self._out.getvalue()
+        if self._sink is not None:
+            self._out.flush()
+            return None
+        else:
+            return self._out.getvalue()
+
+    def generateSplit(self,
+                      name,
+                      root_comp : DataTypeComponent, 
+                      root_action : DataTypeAction,
+                      functions=None,
+                      extra_types=None,
+                      n_parts=8,
+                      jobs=1):
+        """Generates the data model as up to 'n_parts' translation units,
+        which can be compiled in parallel, and an index header. Returns a
+        list of (file name, text), with the index header first.
+
+        Parts hold contiguous runs of the dependency-ordered types, so 
+        the index's <name>_build() function registers them in dependency
+        order by calling the parts in turn. With 'jobs' > 1, parts are
+        generated by that many forked worker processes"""
+        global _split_gen
+        if not self._ctxt.isidentifier():
+            raise Exception("Split generation requires an identifier as the context (%s)" % self._ctxt)
+        types = self._collect(root_comp, root_action)
+        # Parts refer to the tables through local aliases
+        self._tbl_pref = ""
+        self._split_types = types
+        self._split_functions = functions if functions is not None else []
+        self._split_extra_types = extra_types
+        # Every part refers to the functions that part 0 declares
+        for fi,f in enumerate(self._split_functions):
+            self._func_h_m[f.name()] = fi
+
+        part_l = self._partition(types, max(1, n_parts))
+        args_l = []
+        for pi,(start,end) in enumerate(part_l):
+            args_l.append((name, pi, start, end))
+
+        if jobs > 1 and len(part_l) > 1:
+            # Workers are forked, and so share the type model with the 
+            # parent rather than receiving a copy of it
+            _split_gen = self
+            try:
+                with multiprocessing.get_context("fork").Pool(min(jobs, len(part_l))) as pool:
+                    text_l = pool.map(_gen_part, args_l)
+            finally:
+                _split_gen = None
+        else:
+            text_l = list(map(lambda a: self._genPart(*a), args_l))
+
+        ret = [("%s.h" % name, self._genIndex(name, len(part_l), root_comp, root_action))]
+        for pi,text in enumerate(text_l):
+            ret.append(("%s_part%d.cpp" % (name, pi), text))
+        return ret
+
+    def _collect(self, root_comp, root_action):
+        # Collect types first, since de-duplication affects how types
+        # are referenced in function signatures
+        collector = CollectTypeDeps(dedup=self._dedup_types)
+        types = collector.collect(root_comp, root_action)
+        self._type_alias_m = collector.aliases()
+
+        self._comp_h_m = {}
+        self._action_h_m = {}
+        self._func_h_m = {}
+        for t in types:
+            if isinstance(t, DataTypeComponent):
+                self._comp_h_m[id(t)] = len(self._comp_h_m)
+            elif isinstance(t, DataTypeAction):
+                self._action_h_m[id(t)] = len(self._action_h_m)
+        return types
+
+    def _genFunctions(self, functions):
+        # First, declare all functions. Each is recorded in a table, 
+        # such that bodies and calls refer to it by index rather than
+        # looking it up by name
+        self._define_func = False
+        for fi,f in enumerate(functions):
+#            if f.hasFlags(DataTypeFunctionFlags.Core):
+#                continue
+
+            self.println("{")
+            self.inc_indent()
+            f.accept(self)
+            self.println("%s[%d] = %s_t;" % (
+                self._tbl("functions"),
+                fi,
+                self.identifier(f.name())))
+            self._func_h_m[f.name()] = fi
+            self.dec_indent()
+            self.println("}")
+        self._define_func = True
+        for f in functions:
+            if f.hasFlags(DataTypeFunctionFlags.Core):
+                continue
+
+            self.println("{")
+            self.inc_indent()
+            self.println("zsp::arl::dm::IDataTypeFunction *%s_t = %s;" % (
+                self.identifier(f.name()),
+                self._funcRef(f)))
+            if len(f.getImportSpecs()) > 0:
+                self.println("%s_t->addImportSpec(" % ( self.identifier(f.name())))
+                self.inc_indent()
+                self.println("%s->mkDataTypeFunctionImport(\"%s\", false, false)" % (
+                    self._ctxt,
+                    "X",
+                ))
+                self.dec_indent()
+                self.println(");")
+            else:
+                self.println("%s_t->setBody(" % f.name())
+                self.inc_indent()
+                f.getBody().accept(self)
+                self.dec_indent()
+                self.println(");")
+            self.dec_indent()
+            self.println("}")
+
+    def _genExtraTypes(self, extra_types):
+        if extra_types is not None:
+            for et in extra_types:
+                if _dbg.en:
+                    _dbg.debug("ET: %s" % str(et))
+                self.println("{")
+                self.inc_indent()
+                et.accept(self)
+                self.dec_indent()
+                self.println("}")
+
+    @staticmethod
+    def _weight(t):
+        """Approximates the amount of text generated for type 't'"""
+        ret = 1 + len(t.getFields()) + len(t.getConstraints())
+        if hasattr(t, "getExecs"):
+            ret += len(t.getExecs())
+        return ret
+
+    def _partition(self, types, n_parts):
+        """Splits 'types' into at most 'n_parts' contiguous (start, end) 
+        ranges of similar weight"""
+        if len(types) == 0:
+            return [(0, 0)]
+        total = sum(map(ZspDataModelCppGen._weight, types))
+        target = total / min(n_parts, len(types))
+        ret = []
+        start = 0
+        acc = 0
+        for i,t in enumerate(types):
+            acc += ZspDataModelCppGen._weight(t)
+            if acc >= target*(len(ret)+1) and len(ret)+1 < n_parts:
+                ret.append((start, i+1))
+                start = i+1
+        if start < len(types):
+            ret.append((start, len(types)))
+        return ret
+
+    def _tbl(self, name):
+        return self._tbl_pref + name
+
+    def _tablesType(self, name):
+        return "%s_tables_t" % self.identifier(name)
+
+    def _partSignature(self, name, pi):
+        return "void %s_part%d(zsp::arl::dm::IContext *%s, %s &tables)" % (
+            self.identifier(name), pi, self._ctxt, self._tablesType(name))
+
+    def _emitTableAliases(self):
+        # Generated code refers to the tables by these names
+        self.println("zsp::arl::dm::IDataTypeComponent **comp_types = tables.comp_types;")
+        self.println("zsp::arl::dm::IDataTypeAction **action_types = tables.action_types;")
+        self.println("zsp::arl::dm::IDataTypeFunction **functions = tables.functions;")
+
+    def _genPart(self, name, pi, start, end):
+        out = self._out
+        self._out = io.StringIO()
+        try:
+            self.println("// Part %d of the %s data model" % (pi, name))
+            self.println("#include \"%s.h\"" % name)
+            self.println("")
+            self.println("%s {" % self._partSignature(name, pi))
+            self.inc_indent()
+            self._emitTableAliases()
+            if pi == 0:
+                self._genFunctions(self._split_functions)
+                self._genExtraTypes(self._split_extra_types)
+            for t in self._split_types[start:end]:
+                t.accept(self)
+            self.dec_indent()
+            self.println("}")
+            return self._out.getvalue()
+        finally:
+            self._out = out
+
+    def _genIndex(self, name, n_parts, root_comp, root_action):
+        out = self._out
+        self._out = io.StringIO()
+        try:
+            guard = "INCLUDED_%s_H" % self.identifier(name).upper()
+            self.println("// Index of the %s data model. Generated parts are listed" % name)
+            self.println("// in dependency order")
+            self.println("#ifndef %s" % guard)
+            self.println("#define %s" % guard)
+            self.println("#include \"zsp/arl/dm/IContext.h\"")
+            self.println("")
+            self.println("struct %s {" % self._tablesType(name))
+            self.inc_indent()
+            self.println("zsp::arl::dm::IDataTypeComponent *comp_types[%d];" % max(1, len(self._comp_h_m)))
+            self.println("zsp::arl::dm::IDataTypeAction *action_types[%d];" % max(1, len(self._action_h_m)))
+            self.println("zsp::arl::dm::IDataTypeFunction *functions[%d];" % max(1, len(self._split_functions)))
+            self.dec_indent()
+            self.println("};")
+            self.println("")
+            for pi in range(n_parts):
+                self.println("%s;" % self._partSignature(name, pi))
+            self.println("")
+            self.println("static inline void %s_build(" % self.identifier(name))
+            self.inc_indent()
+            self.println("zsp::arl::dm::IContext *%s," % self._ctxt)
+            self.println("zsp::arl::dm::IDataTypeComponent **root_comp,")
+            self.println("zsp::arl::dm::IDataTypeAction **root_action) {")
+            self.println("%s tables = {};" % self._tablesType(name))
+            for pi in range(n_parts):
+                self.println("%s_part%d(%s, tables);" % (self.identifier(name), pi, self._ctxt))
+            self._emitTableAliases()
+            self.println("*root_comp = %s;" % self._compRef(root_comp))
+            self.println("*root_action = %s;" % self._actionRef(root_action))
+            self.dec_indent()
+            self.println("}")
+            self.println("")
+            self.println("#endif /* %s */" % guard)
+            return self._out.getvalue()
+        finally:
+            self._out = out
+
+    def _compRef(self, t, name=None):
+        h = self._comp_h_m.get(id(t), None)
+        if h is not None:
+            return "%s[%d]" % (self._tbl("comp_types"), h)
+        else:
+            return "%s->findDataTypeComponent(\"%s\")" % (
+                self._ctxt,
+                t.name() if name is None else name)
+
+    def _actionRef(self, t):
+        h = self._action_h_m.get(id(t), None)
+        if h is not None:
+            return "%s[%d]" % (self._tbl("action_types"), h)
+        else:
+            return "%s->findDataTypeAction(\"%s\")" % (self._ctxt, t.name())
+
+    def _funcRef(self, f):
+        h = self._func_h_m.get(f.name(), None)
+        if h is not None:
+            return "%s[%d]" % (self._tbl("functions"), h)
+        else:
+            return "%s->findDataTypeFunction(\"%s\")" % (self._ctxt, f.name())
     
     def visitDataTypeComponent(self, i: DataTypeComponent):
         if self._emit_type_mode > 0:
-            self.write("%s->findDataTypeComponent(\"%s\")" % (
-                self._ctxt,
-                i.name()))
+            self.write(self._compRef(i))
         else:
             self.println("{")
             self.inc_indent()
@@ -132,10 +403,18 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
             self.println("%s->addDataTypeComponent(%s_t);" % (
                 self._ctxt, 
                 self.leaf_name(i.name())))
+            if id(i) in self._comp_h_m.keys():
+                self.println("%s[%d] = %s_t;" % (
+                    self._tbl("comp_types"),
+                    self._comp_h_m[id(i)],
+                    self.leaf_name(i.name())))
 
             self._type_s.append(i)
-            for f in i.getFields():
-                f.accept(self)
+            if self._reg_tables:
+                self._emitFieldsRegTables(i)
+            else:
+                for f in i.getFields():
+                    f.accept(self)
             for c in i.getConstraints():
                 c.accept(self)
             for e in i.getExecs():
@@ -148,6 +427,82 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
             self.dec_indent()
             self.println("}")
             
+    def _emitFieldsRegTables(self, i):
+        # Field order determines field index, so each contiguous run 
+        # of register fields becomes its own table. Register arrays are
+        # already a single field, and are emitted directly
+        reg_l = []
+        for f in i.getFields():
+            if isinstance(f, TypeFieldReg) and f.getCount() == 0:
+                reg_l.append(f)
+            else:
+                if len(reg_l) > 0:
+                    self._emitRegTable(reg_l)
+                    reg_l = []
+                f.accept(self)
+        if len(reg_l) > 0:
+            self._emitRegTable(reg_l)
+
+    def _emitRegTable(self, reg_l):
+        # Register types are typically shared by many registers, so 
+        # each type is looked up once and referenced by index
+        type_l = []
+        type_idx_m = {}
+        for r in reg_l:
+            t = self._type_alias_m.get(id(r.getDataType()), r.getDataType())
+            if id(t) not in type_idx_m.keys():
+                type_idx_m[id(t)] = len(type_l)
+                type_l.append(t)
+
+        self.println("{ // Register table (%d registers)" % len(reg_l))
+        self.inc_indent()
+        self.println("vsc::dm::IDataType *reg_types[] = {")
+        self.inc_indent()
+        for t in type_l:
+            self.write(self.ind())
+            self._emit_type_mode += 1
+            t.accept(self)
+            self._emit_type_mode -= 1
+            self.write(",\n")
+        self.dec_indent()
+        self.println("};")
+        self.println("static constexpr struct {")
+        self.inc_indent()
+        self.println("const char *name;")
+        self.println("int64_t    offset;")
+        self.println("uint32_t   type_idx;")
+        self.dec_indent()
+        self.println("} regs[] = {")
+        self.inc_indent()
+        for r in reg_l:
+            self.println("{\"%s\", %d, %d}," % (
+                r.name(),
+                r.getOffset(),
+                type_idx_m[id(self._type_alias_m.get(id(r.getDataType()), r.getDataType()))]))
+        self.dec_indent()
+        self.println("};")
+        self.println("for (const auto &r : regs) {")
+        self.inc_indent()
+        self.println("zsp::arl::dm::ITypeFieldReg *reg_f = %s->mkTypeFieldReg(" % self._ctxt)
+        self.inc_indent()
+        self.println("r.name,")
+        self.println("reg_types[r.type_idx],")
+        self.println("false);")
+        self.dec_indent()
+        self.println("reg_f->setOffset(r.offset);")
+        self.println("%s_t->addField(reg_f);" % self.leaf_name(self._type_s[-1].name()))
+        self.dec_indent()
+        self.println("}")
+        self.dec_indent()
+        self.println("}")
+
+    def visitDataTypeStruct(self, i: DataTypeStruct):
+        if self._emit_type_mode > 0 and id(i) in self._type_alias_m.keys():
+            # Refer to the shared type in place of its duplicate
+            super().visitDataTypeStruct(self._type_alias_m[id(i)])
+        else:
+            super().visitDataTypeStruct(i)
+
     def visitDataTypeFunction(self, i: DataTypeFunction):
         if self._define_func:
             if len(i.getImportSpecs()) == 0:
@@ -233,9 +588,7 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
     def visitTypeExprMethodCallContext(self, i: TypeExprMethodCallContext):
         self.println("%s->mkTypeExprMethodCallContext(" % self._ctxt)
         self.inc_indent()
-        self.println("%s->findDataTypeFunction(\"%s\")," % (
-            self._ctxt,
-            i.getTarget().name()))
+        self.println("%s," % self._funcRef(i.getTarget()))
         self.push_comma(True)
         i.getContext().accept(self)
         self.pop_comma()
@@ -250,12 +603,22 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
         self.dec_indent()
         self.println(")%s" % self.comma())
 
+    def visitTypeExprArrIndex(self, i: TypeExprArrIndex):
+        self.println("%s->mkTypeExprArrIndex(" % self._ctxt)
+        self.inc_indent()
+        self.push_comma(True)
+        i.getRootExpr().accept(self)
+        self.pop_comma()
+        self.push_comma(False)
+        i.getIndexExpr().accept(self)
+        self.pop_comma()
+        self.dec_indent()
+        self.println(")%s" % self.comma())
+
     def visitTypeExprMethodCallStatic(self, i: TypeExprMethodCallStatic):
         self.println("%s->mkTypeExprMethodCallStatic(" % self._ctxt)
         self.inc_indent()
-        self.println("%s->findDataTypeFunction(\"%s\")," % (
-            self._ctxt,
-            i.getTarget().name()))
+        self.println("%s," % self._funcRef(i.getTarget()))
         self.println("{")
         self.inc_indent()
         for ii,p in enumerate(i.getParameters()):
@@ -312,6 +675,9 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
         self.println("false);")
         self.dec_indent()
         self.println("%s_f->setOffset(%d);" % (self.leaf_name(i.name()), i.getOffset()))
+        if i.getCount() > 0:
+            self.println("%s_f->setCount(%d);" % (self.leaf_name(i.name()), i.getCount()))
+            self.println("%s_f->setStride(%d);" % (self.leaf_name(i.name()), i.getStride()))
         self.println("%s_t->addField(%s_f);" % (
             self.leaf_name(self._type_s[-1].name()),
             self.leaf_name(i.name())))
@@ -331,10 +697,7 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
     
     def visitDataTypeAction(self, i: DataTypeAction):
         if self._emit_type_mode > 0:
-            self.write("%s->findDataTypeAction(\"%s\")" % (
-                self._ctxt,
-                i.name()
-            ))
+            self.write(self._actionRef(i))
         else:
             self.println("{ // Declare action type %s" % i.name())
             self.inc_indent()
@@ -346,6 +709,11 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
                 self._ctxt,
                 self.leaf_name(i.name())
             ))
+            if id(i) in self._action_h_m.keys():
+                self.println("%s[%d] = %s_t;" % (
+                    self._tbl("action_types"),
+                    self._action_h_m[id(i)],
+                    self.leaf_name(i.name())))
             self._type_s.append(i)
             for f in i.getFields():
                 if f.name() != "comp":
@@ -357,13 +725,13 @@ class ZspDataModelCppGen(VscDataModelCppGen,VisitorBase):
                 e.accept(self)
 
             self._type_s.pop()
-            self.println("%s_t->setComponentType(%s->findDataTypeComponent(\"%s\"));" % (
+            comp_t = i.getComponentType()
+            comp_ref = self._compRef(comp_t, self.leaf_name(comp_t.name()))
+            self.println("%s_t->setComponentType(%s);" % (
                 self.leaf_name(i.name()),
-                self._ctxt,
-                self.leaf_name(i.getComponentType().name())))
-            self.println("%s->findDataTypeComponent(\"%s\")->addActionType(%s_t);" % (
-                self._ctxt,
-                self.leaf_name(i.getComponentType().name()),
+                comp_ref))
+            self.println("%s->addActionType(%s_t);" % (
+                comp_ref,
                 self.leaf_name(i.name())))
             self.dec_indent()
             self.println("}")
@@ -10,6 +10,9 @@ from .exec_group import ExecGroup
 from .exec_kind_e import ExecKindE
 from .rt_ctxt import RtCtxt
 from .type_info import TypeInfo
+from .debug import Debug
+
+_dbg = Debug.get("impl")
 
 class ImplBase(object):
     
@@ -65,8 +68,9 @@ class ImplBase(object):
     @staticmethod
     async def _evalExecTarget(self, kind : ExecKindE):
         typeinfo = TypeInfo.get(typeworks.TypeInfo.get(type(self)))
-        print("_evalExecTarget: type=%s typeinfo=%s" % (
-            str(type(self)), str(typeinfo)), flush=True)
+        if _dbg.en:
+            _dbg.debug("_evalExecTarget: type=%s typeinfo=%s" % (
+                str(type(self)), str(typeinfo)))
 
         if kind in typeinfo._exec_m.keys():
             await self._evalExecTargetGroup(typeinfo._exec_m[kind])
@@ -0,0 +1,64 @@
+#****************************************************************************
+#* lazy_component_field.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+
+class LazyComponentField(object):
+    """Stands in for a subcomponent facade that has not been created yet.
+    The native model (from initCompTree) exists regardless, so only the
+    Python facade and its model-info are deferred. The facade is created
+    on first attribute access, or when the initialization sequence needs
+    to run an init exec within the subtree"""
+    __slots__ = ("_lz_ti", "_lz_modelinfo_p", "_lz_name", "_lz_idx", "_lz_slot", "_lz_mi", "_lz_obj")
+
+    def __init__(self, ti, modelinfo_p, name, idx, slot):
+        object.__setattr__(self, "_lz_ti", ti)
+        object.__setattr__(self, "_lz_modelinfo_p", modelinfo_p)
+        object.__setattr__(self, "_lz_name", name)
+        object.__setattr__(self, "_lz_idx", idx)
+        # Position in the parent's component_fields
+        object.__setattr__(self, "_lz_slot", slot)
+        # Sub-field placeholder reserved by the parent
+        object.__setattr__(self, "_lz_mi", None)
+        object.__setattr__(self, "_lz_obj", None)
+
+    @property
+    def is_materialized(self):
+        return self._lz_obj is not None
+
+    def materialize(self):
+        if self._lz_obj is None:
+            obj = self._lz_ti.materialize(self)
+            object.__setattr__(self, "_lz_obj", obj)
+        return self._lz_obj
+
+    def __getattr__(self, name):
+        # Only called for names not found on the proxy itself
+        return getattr(self.materialize(), name)
+
+    def __setattr__(self, name, v):
+        setattr(self.materialize(), name, v)
+
+    def __repr__(self):
+        if self._lz_obj is None:
+            return "<lazy %s %s>" % (self._lz_ti.info.T.__name__, self._lz_name)
+        else:
+            return repr(self._lz_obj)
+
@@ -0,0 +1,275 @@
+#****************************************************************************
+#* mem_stats.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import gc
+import json
+import sys
+import types
+import typeworks
+import vsc_dataclasses.impl as vsc_impl
+import vsc_dataclasses.impl.context as vsc_ctxt
+from .context import DataTypeAction, DataTypeActivity, DataTypeComponent, DataTypeFunction
+from .debug import Debug
+
+_dbg = Debug.get("impl")
+
+class MemSnapshot(object):
+    """Object counts and approximate bytes, as {category: {key: [count,
+    bytes]}}. Snapshots can be saved, loaded, and subtracted, such that
+    a regression check can compare a model library against a baseline"""
+
+    def __init__(self, stats=None):
+        self.stats = {} if stats is None else stats
+
+    def add(self, cat, key, count, nbytes):
+        e = self.stats.setdefault(cat, {}).setdefault(key, [0, 0])
+        e[0] += count
+        e[1] += nbytes
+
+    def total(self, cat=None):
+        """Returns (count, bytes) over one category, or over the model
+        categories (all but 'class', which counts the same objects again)"""
+        cat_l = [cat] if cat is not None else [c for c in self.stats.keys() if c != "class"]
+        count = nbytes = 0
+        for c in cat_l:
+            for n,b in self.stats.get(c, {}).values():
+                count += n
+                nbytes += b
+        return (count, nbytes)
+
+    def diff(self, base) -> 'MemSnapshot':
+        """Returns the change from 'base' to this snapshot. Entries that
+        did not change are omitted"""
+        ret = MemSnapshot()
+        for cat in set(self.stats.keys()) | set(base.stats.keys()):
+            cur_m = self.stats.get(cat, {})
+            base_m = base.stats.get(cat, {})
+            for key in set(cur_m.keys()) | set(base_m.keys()):
+                cur = cur_m.get(key, (0, 0))
+                prev = base_m.get(key, (0, 0))
+                if cur[0] != prev[0] or cur[1] != prev[1]:
+                    ret.add(cat, key, cur[0]-prev[0], cur[1]-prev[1])
+        return ret
+
+    def report(self, top=20) -> str:
+        """Returns a text summary: per-category totals, then the 'top'
+        entries of each category by bytes"""
+        ret = []
+        ret.append("%-16s %10s %14s" % ("Category", "Count", "Bytes"))
+        for cat in sorted(self.stats.keys()):
+            count, nbytes = self.total(cat)
+            ret.append("%-16s %10d %14d" % (cat, count, nbytes))
+        for cat in sorted(self.stats.keys()):
+            ret.append("")
+            ret.append("%s:" % cat)
+            ent_l = sorted(self.stats[cat].items(), key=lambda e: -abs(e[1][1]))
+            for key,(count,nbytes) in ent_l[:top]:
+                ret.append("  %-50s %10d %14d" % (key, count, nbytes))
+        return "\n".join(ret)
+
+    def save(self, path):
+        with open(path, "w") as fp:
+            json.dump(self.stats, fp, indent=2, sort_keys=True)
+
+    @staticmethod
+    def load(path) -> 'MemSnapshot':
+        with open(path, "r") as fp:
+            return MemSnapshot(json.load(fp))
+
+class MemStats(object):
+    """Walks the Python data model (context) and the facades reachable
+    from 'roots', and attributes each object to the nearest enclosing
+    type or facade. Categories are:
+    - type:action, type:component, type:function, type:struct: data-model
+      types by name, including captured activity and exec IR
+    - component, reg_group, action, struct: facades by Python type, with
+      their ModelInfo trees, as '<kind>:inst' or '<kind>:type' depending
+      on whether the facade is bound to a model field or a type field
+    - context: the context's own tables
+    With 'classes', all live zsp_dataclasses, vsc_dataclasses, and
+    typeworks objects are also counted by class ('class'). This includes
+    objects the walk can't reach, such as generator buffers and pools.
+
+    Bytes are sys.getsizeof sums, and so approximate. Objects of a native
+    context are opaque, and only their Python wrappers are counted"""
+
+    CLASS_MODULES = ("zsp_dataclasses", "vsc_dataclasses", "typeworks")
+
+    _ATOM_T = (str, bytes, bytearray, int, float, complex, bool, type(None))
+
+    # Shared code and runtime state, rather than model data
+    _SKIP_T = (type, types.ModuleType, types.FunctionType, types.BuiltinFunctionType,
+               types.MethodType, types.CodeType, types.FrameType, types.CoroutineType,
+               types.GeneratorType)
+
+    def __init__(self, ctxt=None):
+        self._ctxt = ctxt
+        self._kind_m = {}
+        self._slot_m = {}
+
+    def snapshot(self, *roots, classes=True) -> MemSnapshot:
+        ret = MemSnapshot()
+        seen = set()
+        queue = []
+        for r in reversed(roots):
+            queue.append((r,) + self._boundary(r, ("other", type(r).__qualname__)))
+        # The context goes first, such that types reachable from both the
+        # context and a facade are attributed to the type
+        if self._ctxt is not None:
+            queue.append((self._ctxt, "context", type(self._ctxt).__qualname__))
+
+        # Each boundary object (type or facade) is walked separately, and
+        # stops at the boundaries it reaches, which are walked in turn
+        while len(queue) > 0:
+            root, cat, key = queue.pop()
+            if id(root) in seen:
+                continue
+            ret.add(cat, key, 1, self._walk(root, seen, queue))
+
+        if classes:
+            self._countClasses(ret)
+        if _dbg.en:
+            _dbg.debug("MemStats: %d objects, %d bytes" % ret.total())
+        return ret
+
+    def _walk(self, root, seen, queue):
+        nbytes = 0
+        stack = [root]
+        while len(stack) > 0:
+            o = stack.pop()
+            if id(o) in seen:
+                continue
+            if o is not root:
+                b = self._boundary(o, None)
+                if b is not None:
+                    queue.append((o,) + b)
+                    continue
+                if isinstance(o, vsc_impl.ModelInfo):
+                    # A ModelInfo belongs to its facade
+                    obj = getattr(o, "obj", None)
+                    if obj is not None and obj is not root and self._boundary(obj, None) is not None:
+                        stack.append(obj)
+                        continue
+            if isinstance(o, MemStats._SKIP_T):
+                continue
+            seen.add(id(o))
+            nbytes += sys.getsizeof(o)
+            if not isinstance(o, MemStats._ATOM_T):
+                self._children(o, stack)
+        return nbytes
+
+    def _children(self, o, stack):
+        if isinstance(o, dict):
+            stack.extend(o.keys())
+            stack.extend(o.values())
+        elif isinstance(o, (list, tuple, set, frozenset)):
+            stack.extend(o)
+        else:
+            try:
+                stack.append(object.__getattribute__(o, "__dict__"))
+            except AttributeError:
+                pass
+            for s in self._slots(type(o)):
+                try:
+                    stack.append(object.__getattribute__(o, s))
+                except AttributeError:
+                    pass
+
+    def _slots(self, t):
+        ret = self._slot_m.get(t, None)
+        if ret is None:
+            ret = []
+            for c in t.__mro__:
+                s = c.__dict__.get("__slots__", ())
+                ret.extend([s] if isinstance(s, str) else s)
+            ret = [s for s in ret if s not in ("__dict__", "__weakref__")]
+            self._slot_m[t] = ret
+        return ret
+
+    def _boundary(self, o, default):
+        """Returns (category, key) when 'o' is a type or facade"""
+        t = type(o)
+        kind = self._kind_m.get(t, False)
+        if kind is False:
+            kind = self._kind(t)
+            self._kind_m[t] = kind
+        if kind is None:
+            return default
+        elif kind.startswith("type:"):
+            try:
+                return (kind, o.name())
+            except Exception:
+                return (kind, t.__qualname__)
+        else:
+            try:
+                mi = object.__getattribute__(o, "_modelinfo")
+                is_inst = isinstance(mi.libobj, vsc_ctxt.ModelField)
+            except AttributeError:
+                is_inst = False
+            return ("%s:%s" % (kind, "inst" if is_inst else "type"), t.__qualname__)
+
+    def _kind(self, t):
+        if issubclass(t, DataTypeActivity):
+            # Activities are part of their action type
+            return None
+        elif issubclass(t, DataTypeAction):
+            return "type:action"
+        elif issubclass(t, DataTypeComponent):
+            return "type:component"
+        elif issubclass(t, DataTypeFunction):
+            return "type:function"
+        elif issubclass(t, vsc_ctxt.DataTypeStruct):
+            return "type:struct"
+        if issubclass(t, MemStats._ATOM_T) or issubclass(t, (dict, list, tuple, set)):
+            return None
+
+        from .type_info import TypeInfo
+        from .typeinfo_action import TypeInfoAction
+        from .typeinfo_component import TypeInfoComponent
+        from .typeinfo_reg_group import TypeInfoRegGroup
+        try:
+            ti = typeworks.TypeInfo.get(t, False)
+        except Exception:
+            ti = None
+        if ti is None:
+            return None
+        ti_a = TypeInfo.get(ti, False)
+        if isinstance(ti_a, TypeInfoRegGroup):
+            return "reg_group"
+        elif isinstance(ti_a, TypeInfoComponent):
+            return "component"
+        elif isinstance(ti_a, TypeInfoAction):
+            return "action"
+        elif ti_a is not None:
+            return "struct"
+        return None
+
+    def _countClasses(self, snap):
+        for o in gc.get_objects():
+            t = type(o)
+            if not t.__module__.startswith(MemStats.CLASS_MODULES):
+                continue
+            nbytes = sys.getsizeof(o)
+            try:
+                nbytes += sys.getsizeof(object.__getattribute__(o, "__dict__"))
+            except AttributeError:
+                pass
+            snap.add("class", "%s.%s" % (t.__module__, t.__qualname__), 1, nbytes)
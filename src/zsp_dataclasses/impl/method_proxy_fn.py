@@ -20,11 +20,16 @@
 #*
 #****************************************************************************
 import typeworks
+from .buf_t import BufT
 from .input_output_t import InputOutputT
 from .typeinfo_proc_scope import TypeInfoProcScope
 from .type_utils import TypeUtils
 from .context import DataTypeFunctionFlags
+from .target_call import TargetCall
 import zsp_dataclasses.impl.context as ctxt_api
+from .debug import Debug
+
+_dbg = Debug.get("fn")
 
 
 class MethodProxyFn(typeworks.MethodProxy):
@@ -36,12 +41,14 @@ class MethodProxyFn(typeworks.MethodProxy):
         self._rtype = None
         self._params = None
         self._libobj = None
+        self._target = None
 
     def elab_decl(self):
         from .ctor import Ctor
         ctxt = Ctor.inst().ctxt()
 
-        print("elab_decl: %s" % self.T.__name__)
+        if _dbg.en:
+            _dbg.debug("elab_decl: %s" % self.T.__name__)
 
         rtype_dt = None
         if self._rtype is not None:
@@ -64,12 +71,19 @@ class MethodProxyFn(typeworks.MethodProxy):
                 dir = ctxt_api.ParamDir.Out if not t.IsInput else ctxt_api.ParamDir.In
                 t = t.T
 
-            p_ti = TypeUtils().val2TypeInfo(t)
+            if issubclass(t, BufT):
+                # Buffers cross to the target as a handle (cf. chandle)
+                p_dt = ctxt.findDataTypeInt(False, 64)
+                if p_dt is None:
+                    p_dt = ctxt.mkDataTypeInt(False, 64)
+                    ctxt.addDataTypeInt(p_dt)
+            else:
+                p_dt = TypeUtils().val2TypeInfo(t)._lib_typeobj
             self._libobj.addParameter(
                 ctxt.mkDataTypeFunctionParamDecl(
                     p[0], # name
                     dir,
-                    p_ti._lib_typeobj, # Type
+                    p_dt, # Type
                     False,
                     init))
 
@@ -79,7 +93,8 @@ class MethodProxyFn(typeworks.MethodProxy):
 
         # TODO: need to resolve types for rtype and parameters
 
-        print("Elab: %s" % typeworks.localname(self.T))
+        if _dbg.en:
+            _dbg.debug("Elab: %s" % typeworks.localname(self.T))
         pass
 
     def elab_body(self):
@@ -89,7 +104,8 @@ class MethodProxyFn(typeworks.MethodProxy):
         ctor = VscCtor.inst()
 
         if self._is_import:
-            print("Elab: %s" % typeworks.localname(self.T))
+            if _dbg.en:
+                _dbg.debug("Elab: %s" % typeworks.localname(self.T))
         else:
             # TODO: need a scope for function parameters
             params = TypeInfoProcScope(None)
@@ -104,6 +120,15 @@ class MethodProxyFn(typeworks.MethodProxy):
             pass
         pass
 
+    def bind(self, impl, batch_sz=1) -> TargetCall:
+        """Binds the target implementation of an import function, which
+        target exec bodies then call (and await) at runtime"""
+        if not self._is_import:
+            raise Exception("Only import functions can be bound to a target (%s)" % (
+                typeworks.localname(self.T)))
+        self._target = TargetCall(typeworks.localname(self.T), impl, batch_sz)
+        return self._target
+
     def __call__(self, *args, **kwargs):
         from vsc_dataclasses.impl.ctor import Ctor as VscCtor
         from vsc_dataclasses.impl.expr import Expr as VscExpr
@@ -112,18 +137,26 @@ class MethodProxyFn(typeworks.MethodProxy):
         ctor = Ctor.inst()
 
         if vsc_ctor.is_type_mode():
-            print("Function call in type mode")
+            if _dbg.en:
+                _dbg.debug("Function call in type mode")
             params = []
             for a in args:
-                print("a: %s" % str(a))
+                if _dbg.en:
+                    _dbg.debug("a: %s" % str(a))
                 e = VscExpr.toExpr(a)
                 e = vsc_ctor.pop_expr(e)
-                print("Expr: %s" % str(e.model))
+                if _dbg.en:
+                    _dbg.debug("Expr: %s" % str(e.model))
                 params.append(e.model)
             call_expr = ctor.ctxt().mkTypeExprMethodCallStatic(
                 self._libobj,
                 params)
             return VscExpr(call_expr)
+        elif self._target is not None:
+            if len(kwargs) > 0:
+                raise Exception("Target calls to %s take positional arguments only" % (
+                    typeworks.localname(self.T)))
+            return self._target(*args)
         else:
             # TODO: 
             raise Exception("Illegal to invoke function outside type mode")
@@ -0,0 +1,106 @@
+#****************************************************************************
+#* model_eval_batch.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+from .context import ModelEvalNodeT
+from .obj_pool import ObjPool
+
+class ModelEvalNode(object):
+    """One node produced by batched iteration. For action nodes, 'field'
+    is the action field and 'action' is its (already-extracted) Python
+    object. For parallel and sequence nodes, 'iterator' iterates the
+    node's branches or items"""
+    __slots__ = ("kind", "field", "action", "iterator")
+
+    def __init__(self, kind, field=None, action=None, iterator=None):
+        self.set(kind, field, action, iterator)
+
+    def set(self, kind, field=None, action=None, iterator=None):
+        self.kind = kind
+        self.field = field
+        self.action = action
+        self.iterator = iterator
+
+class ModelEvalBatch(object):
+    """Fetches the evaluation nodes of one iterator in batches. Iterators
+    that implement nextBatch() produce a whole batch in one call into the
+    evaluator. Others are advanced node-by-node here, which keeps a single
+    dispatch loop in the caller. Once the iterator reports its end, it is
+    not advanced again"""
+    __slots__ = ("it", "done", "next_batch")
+
+    DEFAULT_BATCH_SZ = 1
+
+    # Nodes are recycled once their batch has been dispatched
+    _node_pool = ObjPool(ModelEvalNode, ModelEvalNode.set, max_free=256)
+
+    def __init__(self, it):
+        self.it = it
+        self.done = False
+        self.next_batch = getattr(it, "nextBatch", None)
+
+    def next(self, max_n):
+        """Returns up to 'max_n' nodes. An empty batch indicates the end
+        of iteration"""
+        if self.done:
+            return []
+        if self.next_batch is not None:
+            ret = self.next_batch(max_n)
+            if ret is not None:
+                if len(ret) == 0:
+                    self.done = True
+                return ret
+            # Batching is unsupported by this iterator
+            self.next_batch = None
+        return self._nextStep(max_n)
+
+    def _nextStep(self, max_n):
+        ret = []
+        it = self.it
+        while len(ret) < max_n:
+            if not it.next():
+                self.done = True
+                break
+            kind = it.type()
+            if kind == ModelEvalNodeT.Action:
+                field = it.action()
+                comp_ref_f = field.getField(0) # Get Component field
+                if comp_ref_f.getRef() is None:
+                    raise Exception("Internal error: comp handle is null")
+                ret.append(ModelEvalBatch._node_pool.acquire(
+                    kind, field, field.getFieldData(), None))
+            else:
+                # Nodes that follow a parallel or sequence must not be
+                # evaluated before the node completes
+                ret.append(ModelEvalBatch._node_pool.acquire(
+                    kind, None, None, it.iterator()))
+                break
+        return ret
+
+    @staticmethod
+    def release(batch):
+        """Returns the nodes of a dispatched batch to the pool. References
+        held by the nodes are dropped, so released nodes don't keep
+        action objects or iterators alive"""
+        for node in batch:
+            if isinstance(node, ModelEvalNode):
+                node.set(None)
+                ModelEvalBatch._node_pool.release(node)
+
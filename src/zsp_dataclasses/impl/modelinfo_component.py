@@ -11,3 +11,19 @@ class ModelInfoComponent(vsc_impl.ModelInfo):
     def addSubComponent(self, comp_mi):
         self.addSubfield(comp_mi)
         self.component_fields.append(comp_mi)
+
+    def addLazySubComponent(self, lz):
+        """Reserves the position of a subcomponent whose facade is deferred.
+        A placeholder holds its sub-field slot, so that later sub-fields
+        get the same index they would without deferral"""
+        placeholder = vsc_impl.ModelInfo(None, lz._lz_name, lz._lz_ti)
+        self.addSubfield(placeholder)
+        object.__setattr__(lz, "_lz_mi", placeholder)
+        self.component_fields.append(lz)
+
+    def resolveLazySubComponent(self, lz, comp_mi):
+        placeholder = lz._lz_mi
+        comp_mi._idx = placeholder._idx
+        comp_mi._parent = self
+        self._subfield_modelinfo[placeholder._idx] = comp_mi
+        self.component_fields[lz._lz_slot] = comp_mi
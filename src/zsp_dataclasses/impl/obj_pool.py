@@ -0,0 +1,68 @@
+#****************************************************************************
+#* obj_pool.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+
+class ObjPool(object):
+    """Free list of reusable runtime objects of one kind. Released objects
+    are reset when they are handed out again, rather than when released,
+    such that 'reset_f' receives the new object's state. Pools may be used
+    from several threads: list append/pop are atomic, and a pop racing
+    with another simply falls back to creating an object"""
+
+    DEFAULT_MAX_FREE = 64
+
+    def __init__(self, create_f=None, reset_f=None, max_free=DEFAULT_MAX_FREE):
+        self._create_f = create_f
+        self._reset_f = reset_f
+        self._max_free = max_free
+        self._free_l = []
+        self.n_created = 0
+        self.n_reused = 0
+
+    def take(self, *args):
+        """Returns a released object, reset with 'args', or None"""
+        try:
+            obj = self._free_l.pop()
+        except IndexError:
+            return None
+        if self._reset_f is not None:
+            self._reset_f(obj, *args)
+        self.n_reused += 1
+        return obj
+
+    def acquire(self, *args):
+        """Returns a released object, or creates one, from 'args'"""
+        obj = self.take(*args)
+        if obj is None:
+            obj = self._create_f(*args)
+            self.n_created += 1
+        return obj
+
+    def release(self, obj):
+        if len(self._free_l) < self._max_free:
+            self._free_l.append(obj)
+
+    def clear(self):
+        self._free_l.clear()
+
+    def __len__(self):
+        return len(self._free_l)
+
@@ -1,16 +1,21 @@
+from .debug import Debug
+
+_dbg = Debug.get("pool")
 
 
 class PoolMetaSzT(type):
 
     def __init__(self, name, bases, dct):
-        print("PoolMetaSzT: name=%s bases=%s dct=%s" % (name, str(bases), str(dct)))
+        if _dbg.en:
+            _dbg.debug("PoolMetaSzT: name=%s bases=%s dct=%s" % (name, str(bases), str(dct)))
         self.type_m = {}
 
     def __getitem__(self, sz):
         from .pool_t import PoolT
 
-        print("PoolMetaSz::__getitem__")
-        print("  T=%s" % str(self.T))
+        if _dbg.en:
+            _dbg.debug("PoolMetaSz::__getitem__")
+            _dbg.debug("  T=%s" % str(self.T))
         if sz in self.type_m.keys():
             return self.type_m[sz]
         else:
@@ -5,6 +5,9 @@ Created on May 12, 2022
 '''
 from .pool_t import PoolT
 from .pool_size import PoolSize
+from .debug import Debug
+
+_dbg = Debug.get("pool")
 
 class PoolMetaT(type):
     
@@ -16,7 +19,8 @@ class PoolMetaT(type):
             return self.type_m[item]
         else:
             t = type("pool_t[%s]" % item.__qualname__, (PoolT,), {})
-            print("Creating pool-type %s" % str(t))
+            if _dbg.en:
+                _dbg.debug("Creating pool-type %s" % str(t))
             t.T = item
             self.type_m[item] = t
             return t
@@ -14,6 +14,7 @@ from .data_type_function import DataTypeFunction
 from .data_type_function_import import DataTypeFunctionImport
 from .data_type_function_param_decl import DataTypeFunctionParamDecl
 from .type_exec import TypeExec
+from .type_expr_arr_index import TypeExprArrIndex
 from .type_expr_method_call_context import TypeExprMethodCallContext
 from .type_expr_method_call_static import TypeExprMethodCallStatic
 from .type_field_activity import TypeFieldActivity
@@ -24,47 +25,84 @@ from .type_proc_stmt_assign import TypeProcStmtAssign
 from .type_proc_stmt_expr import TypeProcStmtExpr
 from .type_proc_stmt_if_else import TypeProcStmtIfElse
 from .type_proc_stmt_scope import TypeProcStmtScope
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
 
 
 class Context(vsc_pyctxt.Context,ctxt_api.Context):
 
     def __init__(self):
         super().__init__()
+        # Types and functions are also indexed by handle: their position
+        # in the corresponding list, which is stable once added
         self._action_t_m = {}
+        self._action_t_l = []
+        self._action_h_m = {}
         self._comp_t_m = {}
+        self._comp_t_l = []
+        self._comp_h_m = {}
         self._data_t_func_m = {}
         self._data_t_func_l = []
+        self._data_t_func_h_m = {}
         CoreLibFactory(self).build()
 
 
+    def saveSnapshot(self, path, key=""):
+        """Saves the elaborated type model. See ContextSnapshot"""
+        from .context_snapshot import ContextSnapshot
+        ContextSnapshot.save(self, path, key)
+
+    @staticmethod
+    def loadSnapshot(path, key="") -> 'Context':
+        """Returns a context loaded from snapshot 'path', or None if the
+        snapshot is missing or stale"""
+        from .context_snapshot import ContextSnapshot
+        return ContextSnapshot.load(path, key)
+
+    def memStats(self, classes=False) -> 'MemSnapshot':
+        """Returns object counts and bytes of the type model. See MemStats"""
+        from ..mem_stats import MemStats
+        return MemStats(self).snapshot(classes=classes)
+
     def findDataTypeAction(self, name) -> 'DataTypeAction':
-        if name in self._action_t_m.keys():
-            return self._action_t_m[name]
-        else:
-            return None
+        return self._action_t_m.get(name, None)
+
+    def findDataTypeActionHandle(self, name) -> int:
+        return self._action_h_m.get(name, -1)
+
+    def getDataTypeActionByHandle(self, h) -> 'DataTypeAction':
+        return self._action_t_l[h]
     
     def mkDataTypeAction(self, name) -> DataTypeAction:
         return DataTypeAction(self, name)
 
     def addDataTypeAction(self, t : DataTypeAction) -> bool:
-        if t._name not in self._action_t_m.keys():
+        if t._name not in self._action_t_m:
             self._action_t_m[t._name] = t
+            self._action_h_m[t._name] = len(self._action_t_l)
+            self._action_t_l.append(t)
             return True
         else:
             return False
 
     def findDataTypeComponent(self, name) -> 'DataTypeComponent':
-        if name in self._comp_t_m.keys():
-            return self._comp_t_m[name]
-        else:
-            return None
+        return self._comp_t_m.get(name, None)
+
+    def findDataTypeComponentHandle(self, name) -> int:
+        return self._comp_h_m.get(name, -1)
+
+    def getDataTypeComponentByHandle(self, h) -> 'DataTypeComponent':
+        return self._comp_t_l[h]
 
     def mkDataTypeComponent(self, name) -> 'DataTypeComponent':
         return DataTypeComponent(name)
 
     def addDataTypeComponent(self, t : 'DataTypeComponent') -> bool:
-        if t._name not in self._comp_t_m.keys():
+        if t._name not in self._comp_t_m:
             self._comp_t_m[t._name] = t
+            self._comp_h_m[t._name] = len(self._comp_t_l)
+            self._comp_t_l.append(t)
             return True
         else:
             return False
@@ -86,15 +124,19 @@ class Context(vsc_pyctxt.Context,ctxt_api.Context):
         return DataTypeFunction(name, rtype, flags)
     
     def addDataTypeFunction(self, f):
-        if f.name() not in self._data_t_func_m.keys():
+        if f.name() not in self._data_t_func_m:
             self._data_t_func_m[f.name()] = f
+            self._data_t_func_h_m[f.name()] = len(self._data_t_func_l)
             self._data_t_func_l.append(f)
 
     def findDataTypeFunction(self, name):
-        if name in self._data_t_func_m.keys():
-            return self._data_t_func_m[name]
-        else:
-            return None
+        return self._data_t_func_m.get(name, None)
+
+    def findDataTypeFunctionHandle(self, name) -> int:
+        return self._data_t_func_h_m.get(name, -1)
+
+    def getDataTypeFunctionByHandle(self, h):
+        return self._data_t_func_l[h]
 
     def getDataTypeFunctions(self):
         return self._data_t_func_l
@@ -126,7 +168,8 @@ class Context(vsc_pyctxt.Context,ctxt_api.Context):
         name,
         dtype : 'DataType',
         attr) -> 'TypeFieldRef':
-        print("mkTypeFieldRef: %s" % name)
+        if _dbg.en:
+            _dbg.debug("mkTypeFieldRef: %s" % name)
         if name.endswith(".Entry"):
             raise Exception("Creating action-named field")
         else:
@@ -144,6 +187,9 @@ class Context(vsc_pyctxt.Context,ctxt_api.Context):
                             owned):
         return TypeFieldRegGroup(name, type, owned)
     
+    def mkTypeExprArrIndex(self, root, index) -> TypeExprArrIndex:
+        return TypeExprArrIndex(root, index)
+
     def mkTypeExprMethodCallContext(self,
                                 target : DataTypeFunction,
                                 context,
@@ -0,0 +1,180 @@
+#****************************************************************************
+#* context_snapshot.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import gc
+import hashlib
+import json
+import os
+import pickle
+import struct
+import sys
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
+
+class ContextSnapshot(object):
+    """Saves and loads an elaborated Context: its action, component, and
+    function types, along with their activities and exec bodies. A tool
+    that only consumes the type model (eg a code generator) can start
+    from a snapshot instead of importing and elaborating the model.
+
+    Snapshots are for tooling only. Ctor doesn't consult them, so
+    evaluation still imports and elaborates the model.
+
+    File layout: an 8-byte magic, a little-endian u32 header length, a
+    JSON header, then the pickled context.
+
+    Unpickling can run arbitrary code. Only load snapshots from a
+    trusted location, such as a cache directory written by the same
+    user"""
+
+    MAGIC = b"ZSPCTXT1"
+    PROTOCOL = 5
+    HDR_OFF = 12
+
+    # Type models are deep object graphs, and pickle recurses per level
+    RECURSION_LIMIT = 20000
+
+    _code_id = None
+
+    @staticmethod
+    def version():
+        try:
+            from importlib.metadata import version
+            return version("zuspec-dataclasses")
+        except Exception:
+            return "unknown"
+
+    @staticmethod
+    def codeId():
+        """Returns a digest of the zsp_dataclasses sources. Unlike the
+        package version, this changes with the code of a source tree or
+        an editable install"""
+        if ContextSnapshot._code_id is None:
+            root = os.path.dirname(os.path.dirname(os.path.dirname(
+                os.path.abspath(__file__))))
+            h = hashlib.sha1()
+            for d, dir_l, file_l in os.walk(root):
+                dir_l.sort()
+                for f in sorted(file_l):
+                    if f.endswith(".py"):
+                        fp = os.path.join(d, f)
+                        h.update(os.path.relpath(fp, root).encode())
+                        with open(fp, "rb") as fd:
+                            h.update(fd.read())
+            ContextSnapshot._code_id = h.hexdigest()
+        return ContextSnapshot._code_id
+
+    @staticmethod
+    def save(ctxt, path, key=""):
+        """Writes 'ctxt' to 'path'. 'key' identifies the model (eg a hash
+        of its sources), and must match when the snapshot is loaded"""
+        hdr = json.dumps({
+            "version" : ContextSnapshot.version(),
+            "code" : ContextSnapshot.codeId(),
+            "python" : "%d.%d" % sys.version_info[:2],
+            "key" : key,
+            "n_actions" : len(ctxt._action_t_m),
+            "n_components" : len(ctxt._comp_t_m),
+            "n_functions" : len(ctxt._data_t_func_l)
+        }, sort_keys=True).encode()
+
+        limit = sys.getrecursionlimit()
+        sys.setrecursionlimit(max(limit, ContextSnapshot.RECURSION_LIMIT))
+        try:
+            payload = pickle.dumps(ctxt, protocol=ContextSnapshot.PROTOCOL)
+        finally:
+            sys.setrecursionlimit(limit)
+
+        tmp_path = "%s.%d.tmp" % (path, os.getpid())
+        with open(tmp_path, "wb") as fp:
+            fp.write(ContextSnapshot.MAGIC)
+            fp.write(struct.pack("<I", len(hdr)))
+            fp.write(hdr)
+            fp.write(payload)
+        os.replace(tmp_path, path)
+        if _dbg.en:
+            _dbg.debug("Saved snapshot %s (%d bytes)" % (path, len(payload)))
+
+    @staticmethod
+    def header(path):
+        """Returns the header of snapshot 'path', or None if the file is
+        not a snapshot"""
+        with open(path, "rb") as fp:
+            return ContextSnapshot._readHeader(fp.read(ContextSnapshot.HDR_OFF), fp.read)
+
+    @staticmethod
+    def _readHeader(prefix, read):
+        if len(prefix) != ContextSnapshot.HDR_OFF or prefix[0:8] != ContextSnapshot.MAGIC:
+            return None
+        hdr_len, = struct.unpack_from("<I", prefix, 8)
+        data = read(hdr_len)
+        if len(data) != hdr_len:
+            return None
+        try:
+            hdr = json.loads(data)
+        except ValueError:
+            return None
+        return hdr if isinstance(hdr, dict) else None
+
+    @staticmethod
+    def load(path, key=""):
+        """Returns the context saved in 'path'. Returns None when the file
+        is missing, isn't a complete snapshot, or was written for a
+        different key, zsp_dataclasses version or source, or Python
+        version. Callers then elaborate as usual.
+
+        Loading unpickles the file, which can run arbitrary code. Only
+        load snapshots from a trusted location"""
+        if not os.path.isfile(path):
+            return None
+        with open(path, "rb") as fp:
+            hdr = ContextSnapshot._readHeader(fp.read(ContextSnapshot.HDR_OFF), fp.read)
+            if hdr is None:
+                if _dbg.en:
+                    _dbg.debug("File %s is not a context snapshot" % path)
+                return None
+            if (hdr.get("key") != key or
+                    hdr.get("version") != ContextSnapshot.version() or
+                    hdr.get("code") != ContextSnapshot.codeId() or
+                    hdr.get("python") != "%d.%d" % sys.version_info[:2]):
+                if _dbg.en:
+                    _dbg.debug("Snapshot %s is stale: %s" % (path, str(hdr)))
+                return None
+
+            limit = sys.getrecursionlimit()
+            sys.setrecursionlimit(max(limit, ContextSnapshot.RECURSION_LIMIT))
+            # Unpickling allocates every type object. The collector
+            # would otherwise repeatedly scan the growing graph
+            gc_en = gc.isenabled()
+            gc.disable()
+            try:
+                ctxt = pickle.load(fp)
+            except Exception as e:
+                # eg a truncated file
+                if _dbg.en:
+                    _dbg.debug("Failed to load snapshot %s: %s" % (path, str(e)))
+                ctxt = None
+            finally:
+                if gc_en:
+                    gc.enable()
+                sys.setrecursionlimit(limit)
+        return ctxt
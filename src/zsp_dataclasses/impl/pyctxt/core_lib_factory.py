@@ -21,6 +21,9 @@
 #****************************************************************************
 from ..context import Context
 from ..context import DataTypeFunctionFlags
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
 
 class CoreLibFactory(object):
 
@@ -40,7 +43,8 @@ class CoreLibFactory(object):
             None,
             False,
             DataTypeFunctionFlags.Core)
-        print("Add std_pkg::print to library")
+        if _dbg.en:
+            _dbg.debug("Add std_pkg::print to library")
         self._ctxt.addDataTypeFunction(print_f)
         print_f.addImportSpec(
             self._ctxt.mkDataTypeFunctionImport("X", False, False))
@@ -105,6 +109,33 @@ class CoreLibFactory(object):
             self._ctxt.mkDataTypeFunctionImport("X", False, False))
         self._ctxt.addDataTypeFunction(reg_write_val_masked)
 
+        # Bulk accesses. The context is the first (or only) register, such
+        # that the target can issue each call as one burst transaction
+        reg_write_block = self._ctxt.mkDataTypeFunction(
+            "pss::core::reg_write_block",
+            None,
+            False,
+            DataTypeFunctionFlags.Core)
+        reg_write_block.addImportSpec(
+            self._ctxt.mkDataTypeFunctionImport("X", False, False))
+        self._ctxt.addDataTypeFunction(reg_write_block)
+        reg_read_block = self._ctxt.mkDataTypeFunction(
+            "pss::core::reg_read_block",
+            None,
+            False,
+            DataTypeFunctionFlags.Core)
+        reg_read_block.addImportSpec(
+            self._ctxt.mkDataTypeFunctionImport("X", False, False))
+        self._ctxt.addDataTypeFunction(reg_read_block)
+        reg_modify = self._ctxt.mkDataTypeFunction(
+            "pss::core::reg_modify",
+            None,
+            False,
+            DataTypeFunctionFlags.Core)
+        reg_modify.addImportSpec(
+            self._ctxt.mkDataTypeFunctionImport("X", False, False))
+        self._ctxt.addDataTypeFunction(reg_modify)
+
         read8 = self._ctxt.mkDataTypeFunction(
             "reg_addr_pkg::read8",
             None,
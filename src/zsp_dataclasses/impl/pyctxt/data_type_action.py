@@ -4,6 +4,9 @@ import zsp_dataclasses.impl.context as ctxt_api
 import vsc_dataclasses.impl.context as vsc_ctxt
 import vsc_dataclasses.impl.pyctxt as vsc_pyctxt
 from .data_type_arl_struct import DataTypeArlStruct
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
 
 class DataTypeAction(ctxt_api.DataTypeAction,DataTypeArlStruct):
     
@@ -16,14 +19,16 @@ class DataTypeAction(ctxt_api.DataTypeAction,DataTypeArlStruct):
             "comp", 
             None, 
             vsc_ctxt.TypeFieldAttr.NoAttr))
-        print("Field: %s (%s)" % (self.getField(0).name(), type(self.getField(0)).__qualname__))
+        if _dbg.en:
+            _dbg.debug("Field: %s (%s)" % (self.getField(0).name(), type(self.getField(0)).__qualname__))
 
     def getComponentType(self) -> 'DataTypeComponent':
         return self._comp_t
     
     def setComponentType(self, t : 'DataTypeComponent'):
-        print("setComponent")
-        print("Field: %s (%s)" % (self.getField(0).name(), type(self.getField(0)).__qualname__))
+        if _dbg.en:
+            _dbg.debug("setComponent")
+            _dbg.debug("Field: %s (%s)" % (self.getField(0).name(), type(self.getField(0)).__qualname__))
         self.getField(0).setDataType(t)
         self._comp_t = t
         pass
@@ -32,7 +37,8 @@ class DataTypeAction(ctxt_api.DataTypeAction,DataTypeArlStruct):
         return self._fields[0]
     
     def addField(self, f: 'TypeField'):
-        print("DataTypeAction.addField %s" % f.name())
+        if _dbg.en:
+            _dbg.debug("DataTypeAction.addField %s" % f.name())
         if f.name().endswith(".Entry"):
             raise Exception("Bad addition")
         return super().addField(f)
@@ -20,9 +20,10 @@
 #*
 #****************************************************************************
 
+import zsp_dataclasses.impl.context as ctxt_api
 from .data_type_activity_scope import DataTypeActivityScope
 
-class DataTypeActivitySequence(DataTypeActivityScope):
+class DataTypeActivitySequence(ctxt_api.DataTypeActivitySequence,DataTypeActivityScope):
 
     def __init__(self):
         super().__init__()
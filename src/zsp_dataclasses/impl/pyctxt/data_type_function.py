@@ -21,6 +21,9 @@
 #****************************************************************************
 import zsp_dataclasses.impl.context as ctxt
 from typing import List
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
 
 class DataTypeFunction(object):
 
@@ -63,11 +66,12 @@ class DataTypeFunction(object):
         return self._flags
     
     def hasFlags(self, f):
-        print("hasFlags: %s %s %d" % (
-            str(self._flags),
-            str(f),
-            (self._flags & f)
-        ))
+        if _dbg.en:
+            _dbg.debug("hasFlags: %s %s %d" % (
+                str(self._flags),
+                str(f),
+                (self._flags & f)
+            ))
         return (self._flags & f) != 0
 
     def accept(self, v):
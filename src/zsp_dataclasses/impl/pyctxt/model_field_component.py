@@ -22,6 +22,9 @@
 
 import zsp_dataclasses.impl.context as ctxt_api
 from vsc_dataclasses.impl.pyctxt.model_field import ModelField
+from ..debug import Debug
+
+_dbg = Debug.get("pyctxt")
 
 class ModelFieldComponent(ctxt_api.ModelFieldComponent,ModelField):
 
@@ -29,6 +32,7 @@ class ModelFieldComponent(ctxt_api.ModelFieldComponent,ModelField):
         ModelField.__init__(self, name, dt)
 
     def initCompTree(self):
-        print("TODO: initCompTree")
+        if _dbg.en:
+            _dbg.debug("TODO: initCompTree")
         pass
 
@@ -0,0 +1,37 @@
+#****************************************************************************
+#* type_expr_arr_index.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import zsp_dataclasses.impl.context as ctxt_api
+
+class TypeExprArrIndex(ctxt_api.TypeExprArrIndex):
+
+    def __init__(self, root, index):
+        self._root = root
+        self._index = index
+
+    def getRootExpr(self):
+        return self._root
+
+    def getIndexExpr(self):
+        return self._index
+
+    def accept(self, v):
+        v.visitTypeExprArrIndex(self)
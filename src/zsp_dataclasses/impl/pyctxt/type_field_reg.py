@@ -28,6 +28,8 @@ class TypeFieldReg(ctxt_api.TypeFieldReg, TypeField):
     def __init__(self, name, type, owned):
         TypeField.__init__(self, name, type, vsc_api.TypeFieldAttr.NoAttr)
         self._offset = -1
+        self._count = 0
+        self._stride = 0
 
     def setOffset(self, off):
         self._offset = off
@@ -35,5 +37,17 @@ class TypeFieldReg(ctxt_api.TypeFieldReg, TypeField):
     def getOffset(self):
         return self._offset
 
+    def setCount(self, count):
+        self._count = count
+
+    def getCount(self):
+        return self._count
+
+    def setStride(self, stride):
+        self._stride = stride
+
+    def getStride(self):
+        return self._stride
+
     def accept(self, v):
         v.visitTypeFieldReg(self)
\ No newline at end of file
@@ -22,10 +22,10 @@
 
 from vsc_dataclasses.impl.pyctxt.visitor_base import VisitorBase as VscVisitorBase
 from ..context import DataTypeAction, DataTypeActivity, DataTypeActivityScope
-from ..context import DataTypeActivityTraverse
+from ..context import DataTypeActivityReplicate, DataTypeActivitySequence, DataTypeActivityTraverse
 from ..context import DataTypeComponent, DataTypeArlStruct, DataTypeFunction, DataTypeFunctionParamDecl
 from ..context import TypeExprMethodCallStatic, TypeProcStmtExpr, TypeProcStmtVarDecl, TypeExprMethodCallContext
-from ..context import TypeExec, TypeProcStmtScope
+from ..context import TypeExec, TypeExprArrIndex, TypeProcStmtScope
 from ..context import TypeFieldReg, TypeFieldRegGroup, TypeProcStmtIfElse
 from ..context import TypeProcStmtAssign
 
@@ -44,6 +44,13 @@ class VisitorBase(VscVisitorBase):
         for a in i.getActivities():
             a.accept(self)
 
+    def visitDataTypeActivityReplicate(self, i : DataTypeActivityReplicate):
+        i.getCount().accept(self)
+        self.visitDataTypeActivityScope(i)
+
+    def visitDataTypeActivitySequence(self, i : DataTypeActivitySequence):
+        self.visitDataTypeActivityScope(i)
+
     def visitDataTypeActivityTraverse(self, i : DataTypeActivityTraverse):
         i.getTarget().accept(self)
 
@@ -72,6 +79,10 @@ class VisitorBase(VscVisitorBase):
     def visitTypeExec(self, i : TypeExec):
         i.getBody().accept(self)
 
+    def visitTypeExprArrIndex(self, i : TypeExprArrIndex):
+        i.getRootExpr().accept(self)
+        i.getIndexExpr().accept(self)
+
     def visitTypeExprMethodCallContext(self, i : TypeExprMethodCallContext):
         i.getTarget().accept(self)
         i.getContext().accept(self)
@@ -21,6 +21,9 @@
 #****************************************************************************
 from .reg_c import RegC
 from .reg_c_meta_meta import RegCMetaMeta
+from .debug import Debug
+
+_dbg = Debug.get("reg")
 
 class RegCMeta(type):
 
@@ -33,7 +36,8 @@ class RegCMeta(type):
         else:
             t = RegCMetaMeta("reg_c[%s]" % item.__qualname__, (RegC,), {})
             t.T = item
-            print("RegCMeta: T=%s" % str(t.T))
+            if _dbg.en:
+                _dbg.debug("RegCMeta: T=%s" % str(t.T))
             self.type_m[item] = t
             return t
 
@@ -24,6 +24,7 @@ import vsc_dataclasses.impl.context as vsc_ctxt
 from vsc_dataclasses.impl.typeinfo_field import TypeInfoField
 from .component_decorator_impl import ComponentDecoratorImpl
 from .component_impl import ComponentImpl
+from .field_reg_c_impl import FieldRegCImpl
 from .reg_c import RegC
 from .type_info import TypeInfo
 from .typeinfo_component import TypeInfoComponent
@@ -31,6 +32,11 @@ from .typeinfo_field_reg_c import TypeInfoFieldRegC
 from .typeinfo_reg_group import TypeInfoRegGroup
 from .type_utils import TypeUtils
 from .ctor import Ctor
+from .debug import Debug
+
+_dbg = Debug.get("reg")
+
+_set_handle = Ctor.sym("pss::core::reg_group::set_handle")
 
 class RegGroupDecoratorImpl(ComponentDecoratorImpl):
 
@@ -42,10 +48,12 @@ class RegGroupDecoratorImpl(ComponentDecoratorImpl):
     def init_annotated_field(self, key, value, has_init, init):
         component_ti = TypeInfoComponent.get(self.get_typeinfo())
 
-        print("key: %s value: %s" % (str(key), str(value)))
+        if _dbg.en:
+            _dbg.debug("key: %s value: %s" % (str(key), str(value)))
         if issubclass(value, RegC):
 
-            print("RegC.T=%s" % str(value.T))
+            if _dbg.en:
+                _dbg.debug("RegC.T=%s" % str(value.T))
             reg_ti = TypeUtils().val2TypeInfo(value.T)
 
             if reg_ti is None:
@@ -55,21 +63,31 @@ class RegGroupDecoratorImpl(ComponentDecoratorImpl):
 #            value_base_ti = TypeInfo.get(value_ti, False)
 
             ctor = Ctor.inst()
-            print("RegC")
+            if _dbg.en:
+                _dbg.debug("RegC")
             field_type_obj = ctor.ctxt().mkTypeFieldReg(
                 key,
                 reg_ti.lib_typeobj,
                 False)
             
+            count = 0
             if has_init:
                 field_type_obj.setOffset(init["offset"])
 
+                # A register array is a single field, regardless of 
+                # the number of elements
+                count = init.get("count", 0)
+                if not isinstance(count, int) or count < 0:
+                    raise Exception("Register array %s has invalid count %s" % (key, str(count)))
+                if count > 0:
+                    field_type_obj.setCount(count)
+                    field_type_obj.setStride(init.get("stride", 0))
 
             # TODO: handle offsets (if present)
 
             # TODO: Hmm... This might not be right either...
             # Maybe we need a TypeInfoReg()?
-            field_fi = TypeInfoFieldRegC(key, reg_ti)
+            field_fi = TypeInfoFieldRegC(key, reg_ti, count)
             component_ti.addField(field_fi, field_type_obj)
 #            component_ti.addField(field_ti, )
 
@@ -89,20 +107,18 @@ class RegGroupDecoratorImpl(ComponentDecoratorImpl):
 
         mi = self._modelinfo
 
-        offset_l = [mi.idx]
-        while mi is not None and mi.idx != -1:
-            print("MI: %s %d %s" % (str(mi), mi.idx, mi.name))
-            offset_l.insert(0, mi.idx)
-            mi = mi.parent
-
+        path = getattr(mi, "_reg_path", None)
+        if path is None:
+            path = FieldRegCImpl.refPath(mi)
+            mi._reg_path = path
 
         root = ctor.ctxt().mkTypeExprFieldRef(
             kind,
             root_off,
-            offset_l
+            list(path)
         )
 
-        set_handle = Ctor.inst().ctxt().findDataTypeFunction("pss::core::reg_group::set_handle")
+        set_handle = ctor.core_fn(_set_handle)
         ctor.proc_scope().addStatement(
             ctor.ctxt().mkTypeProcStmtExpr(
                 ctor.ctxt().mkTypeExprMethodCallContext(
@@ -19,6 +19,9 @@
 #*     Author: 
 #*
 #****************************************************************************
+from .debug import Debug
+
+_dbg = Debug.get("reg")
 
 class RegGroupMetaMeta(type):
 
@@ -26,5 +29,6 @@ class RegGroupMetaMeta(type):
         super().__init__(name, bases, dct)
 
     def __call__(self, offset):
-        print("__call__")
+        if _dbg.en:
+            _dbg.debug("__call__")
         pass
@@ -0,0 +1,215 @@
+#****************************************************************************
+#* resource_allocator.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import itertools
+import threading
+from .debug import Debug
+
+_dbg = Debug.get("resource")
+
+class ResourcePool(object):
+    """Lock/share state of one resource pool. Instance 'i' is locked when
+    bit 'i' of 'lock_bits' is set, and shared when bit 'i' of 'share_bits'
+    is set. Requests that can't be granted wait in FIFO order. A waiting
+    request reserves the instances it touches, such that later requests
+    for those instances can't overtake it"""
+
+    class Waiter(object):
+        __slots__ = ("lock_m", "share_m", "loop", "future")
+
+        def __init__(self, lock_m, share_m, loop, future):
+            self.lock_m = lock_m
+            self.share_m = share_m
+            self.loop = loop
+            self.future = future
+
+    def __init__(self, key, seq):
+        self.key = key
+        # Pools are always acquired in 'seq' order, which rules out
+        # deadlock between requests that span pools
+        self.seq = seq
+        self.lock_bits = 0
+        self.share_bits = 0
+        self.share_cnt = {}
+        self.wait_mask = 0
+        self.waiter_l = []
+        self.n_wait = 0
+        self._lock = threading.Lock()
+
+    def _canGrant(self, lock_m, share_m):
+        return ((lock_m & (self.lock_bits | self.share_bits)) | (share_m & self.lock_bits)) == 0
+
+    def _grant(self, lock_m, share_m):
+        self.lock_bits |= lock_m
+        while share_m:
+            b = share_m & -share_m
+            share_m ^= b
+            self.share_cnt[b] = self.share_cnt.get(b, 0) + 1
+            self.share_bits |= b
+
+    async def acquire(self, lock_m, share_m):
+        with self._lock:
+            if (lock_m | share_m) & self.wait_mask == 0 and self._canGrant(lock_m, share_m):
+                self._grant(lock_m, share_m)
+                return
+            loop = asyncio.get_running_loop()
+            w = ResourcePool.Waiter(lock_m, share_m, loop, loop.create_future())
+            self.waiter_l.append(w)
+            self.wait_mask |= (lock_m | share_m)
+            self.n_wait += 1
+        if _dbg.en:
+            _dbg.debug("Wait on pool %s lock=0x%x share=0x%x" % (
+                str(self.key), lock_m, share_m))
+        try:
+            await w.future
+        except BaseException:
+            # A cancelled waiter must neither hold nor block instances
+            with self._lock:
+                granted = w not in self.waiter_l
+                if not granted:
+                    self.waiter_l.remove(w)
+                    self.wait_mask = 0
+                    for wi in self.waiter_l:
+                        self.wait_mask |= (wi.lock_m | wi.share_m)
+            if granted:
+                self.release(lock_m, share_m)
+            raise
+
+    def release(self, lock_m, share_m):
+        with self._lock:
+            self.lock_bits &= ~lock_m
+            while share_m:
+                b = share_m & -share_m
+                share_m ^= b
+                n = self.share_cnt[b] - 1
+                if n == 0:
+                    del self.share_cnt[b]
+                    self.share_bits &= ~b
+                else:
+                    self.share_cnt[b] = n
+
+            if len(self.waiter_l) > 0:
+                self._grantWaiters()
+
+    def _grantWaiters(self):
+        reserved = 0
+        waiter_l = []
+        for w in self.waiter_l:
+            touch_m = w.lock_m | w.share_m
+            if touch_m & reserved == 0 and self._canGrant(w.lock_m, w.share_m):
+                self._grant(w.lock_m, w.share_m)
+                w.loop.call_soon_threadsafe(ResourcePool._wake, w.future)
+            else:
+                reserved |= touch_m
+                waiter_l.append(w)
+        self.waiter_l = waiter_l
+        self.wait_mask = reserved
+
+    @staticmethod
+    def _wake(future):
+        # The waiter may have been cancelled after it was granted. Its
+        # cancel handler then releases the grant
+        if not future.done():
+            future.set_result(None)
+
+class ResourceAllocator(object):
+    """Arbitrates the lock and share claims of concurrently-evaluated
+    actions. A claim names a resource instance (its 'instance_id'), which
+    the evaluator selected while solving. An action is dispatched once
+    it holds all of its claims, and releases them after its body runs.
+
+    The evaluator doesn't report which pool a claim was bound to. Pools
+    are therefore keyed by resource type, which is exact as long as a
+    scenario has at most one pool of each resource type. Override
+    poolKey() to distinguish pools otherwise"""
+
+    class Grant(object):
+        __slots__ = ("req_l",)
+
+        def __init__(self, req_l):
+            self.req_l = req_l
+
+    def __init__(self):
+        self._pool_m = {}
+        self._pool_lock = threading.Lock()
+        self._seq_c = itertools.count()
+
+    def poolKey(self, claim_ti):
+        return claim_ti.target_ti
+
+    def pool(self, key) -> ResourcePool:
+        ret = self._pool_m.get(key, None)
+        if ret is None:
+            with self._pool_lock:
+                ret = self._pool_m.get(key, None)
+                if ret is None:
+                    ret = ResourcePool(key, next(self._seq_c))
+                    self._pool_m[key] = ret
+        return ret
+
+    def pools(self):
+        return list(self._pool_m.values())
+
+    async def acquire(self, action_f, claim_l) -> 'ResourceAllocator.Grant':
+        """Acquires the claims of action field 'action_f'. 'claim_l' holds
+        (field index, TypeInfoClaim) pairs. Returns the grant to pass to
+        release()"""
+        req_m = {}
+        for idx,claim_ti in claim_l:
+            pool = self.pool(self.poolKey(claim_ti))
+            bit = 1 << self._instanceId(action_f, idx)
+            req = req_m.get(pool.seq, None)
+            if req is None:
+                req = [pool, 0, 0]
+                req_m[pool.seq] = req
+            if claim_ti.is_lock:
+                req[1] |= bit
+            else:
+                req[2] |= bit
+
+        req_l = [req_m[s] for s in sorted(req_m.keys())]
+        for i,req in enumerate(req_l):
+            # Within a pool, a lock and a share of the same instance by
+            # one action is a lock
+            req[2] &= ~req[1]
+            try:
+                await req[0].acquire(req[1], req[2])
+            except BaseException:
+                # Claims already held in other pools must not outlive
+                # a cancelled or failed acquire
+                for pool,lock_m,share_m in reversed(req_l[:i]):
+                    pool.release(lock_m, share_m)
+                raise
+        return ResourceAllocator.Grant(req_l)
+
+    def release(self, grant):
+        for pool,lock_m,share_m in reversed(grant.req_l):
+            pool.release(lock_m, share_m)
+
+    @staticmethod
+    def _instanceId(action_f, idx):
+        res_f = action_f.getField(idx).getRef()
+        if res_f is None:
+            # Unbound claims conflict with each other on instance 0
+            return 0
+        # 'instance_id' is the first field of every resource
+        return res_f.getField(0).val().val_i()
@@ -3,13 +3,29 @@ Created on Apr 24, 2022
 
 @author: mballance
 '''
+import contextlib
+import contextvars
 
 class RtCtxt(object):
+    """Runtime state used while evaluating exec bodies. Instances are 
+    context-local: each thread, each ComponentImpl.eval call, and each 
+    forked parallel branch sees its own exec-group stack"""
     
-    _inst = None
+    _ctxt_v = contextvars.ContextVar("zsp_dataclasses.RtCtxt", default=None)
     
-    def __init__(self):
+    def __init__(self, backend=None, resources=None, listener=None):
         self._exec_group_s = []
+        # Backend evaluating the current scenario
+        self.backend = backend
+        # Arbitrates resource claims between the scenario's branches
+        self.resources = resources
+        # Receives evaluation events. None when profiling is disabled
+        self.listener = listener
+
+    def mkBranch(self):
+        """Returns the context for a parallel branch, which shares the
+        scenario's state but has its own exec-group stack"""
+        return RtCtxt(self.backend, self.resources, self.listener)
     
     def push_exec_group(self, g):
         self._exec_group_s.append(g)
@@ -25,7 +41,22 @@ class RtCtxt(object):
     
     @classmethod
     def inst(cls):
-        if cls._inst is None:
-            cls._inst = RtCtxt()
-        return cls._inst
-    
\ No newline at end of file
+        inst = cls._ctxt_v.get()
+        if inst is None:
+            inst = RtCtxt()
+            cls._ctxt_v.set(inst)
+        return inst
+
+    @classmethod
+    @contextlib.contextmanager
+    def bind(cls, rt_ctxt=None):
+        """Makes 'rt_ctxt' (a new instance by default) the runtime context
+        seen by inst() for the duration of the with block"""
+        if rt_ctxt is None:
+            rt_ctxt = RtCtxt()
+        token = cls._ctxt_v.set(rt_ctxt)
+        try:
+            yield rt_ctxt
+        finally:
+            cls._ctxt_v.reset(token)
+
@@ -30,6 +30,9 @@ from .base_decorator_impl import BaseDecoratorImpl
 from .type_kind_e import TypeKindE
 from .exec_kind_e import ExecKindE
 from .typeinfo_struct import TypeInfoStruct
+from .debug import Debug
+
+_dbg = Debug.get("decorator")
 
 class StructDecoratorImpl(BaseDecoratorImpl):
     
@@ -43,7 +46,8 @@ class StructDecoratorImpl(BaseDecoratorImpl):
     def pre_decorate(self, T):
         struct_ti = TypeInfoStruct.get(self.get_typeinfo())
         struct_ti._kind = self._kind
-        print("struct_ti: %s" % str(struct_ti))
+        if _dbg.en:
+            _dbg.debug("struct_ti: %s" % str(struct_ti))
 
         if self._kind == StructKindE.Resource:
             # Add in built-in 'instance_id' field
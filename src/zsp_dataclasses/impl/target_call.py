@@ -0,0 +1,151 @@
+#****************************************************************************
+#* target_call.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import array
+import asyncio
+import inspect
+import threading
+from .debug import Debug
+
+_dbg = Debug.get("fn")
+
+class TargetCall(object):
+    """Target implementation bound to an import function. Calling it from
+    an exec body returns an awaitable. Buffer arguments (buffer fields, 
+    bytearray, array, memoryview) are passed as a memoryview over the
+    caller's storage, and are never copied.
+
+    With 'batch_sz' > 1, 'impl' receives a list of argument tuples and 
+    returns a list of results. Calls issued before the event loop next 
+    runs its callbacks (eg by the branches of a parallel) are then passed
+    to 'impl' together, in chunks of up to 'batch_sz' calls. 'impl' may
+    return an awaitable in both modes"""
+
+    _BUF_T = (bytearray, bytes, memoryview, array.array)
+
+    def __init__(self, name, impl, batch_sz=1):
+        if batch_sz < 1:
+            raise Exception("batch_sz must be at least 1 (%d)" % batch_sz)
+        self.name = name
+        self._impl = impl
+        self._batch_sz = batch_sz
+        self._lock = threading.Lock()
+        self._pending_m = {}
+        # The loop only keeps weak references to tasks
+        self._task_s = set()
+        self._n_calls = 0
+        self._n_batches = 0
+
+    @property
+    def n_calls(self):
+        return self._n_calls
+
+    @property
+    def n_batches(self):
+        """Number of times 'impl' was invoked"""
+        return self._n_batches
+
+    def __call__(self, *args):
+        args = tuple(TargetCall.marshal(a) for a in args)
+        if self._batch_sz == 1:
+            return self._call(args)
+        else:
+            return self._submit(args)
+
+    @staticmethod
+    def marshal(v):
+        if isinstance(v, TargetCall._BUF_T):
+            return memoryview(v)
+        elif hasattr(v, "get_val"):
+            return v.get_val()
+        else:
+            return v
+
+    async def _call(self, args):
+        with self._lock:
+            self._n_calls += 1
+            self._n_batches += 1
+        ret = self._impl(*args)
+        if inspect.isawaitable(ret):
+            ret = await ret
+        return ret
+
+    def _submit(self, args):
+        loop = asyncio.get_running_loop()
+        future = loop.create_future()
+        with self._lock:
+            self._n_calls += 1
+            # Calls are batched per event loop, since loops on worker
+            # threads (eg BackendThreadPool) complete their own futures
+            pending = self._pending_m.get(loop, None)
+            if pending is None:
+                pending = []
+                self._pending_m[loop] = pending
+                loop.call_soon(self._flush, loop)
+            pending.append((args, future))
+            full = len(pending) >= self._batch_sz
+        if full:
+            self._flush(loop)
+        return future
+
+    def _flush(self, loop):
+        with self._lock:
+            pending = self._pending_m.pop(loop, None)
+            if pending is None:
+                # Already flushed when it became full
+                return
+            self._n_batches += 1
+        if _dbg.en:
+            _dbg.debug("Target call %s: batch of %d" % (self.name, len(pending)))
+        task = loop.create_task(self._run(pending))
+        with self._lock:
+            self._task_s.add(task)
+        task.add_done_callback(self._taskDone)
+
+    def _taskDone(self, task):
+        with self._lock:
+            self._task_s.discard(task)
+
+    async def _run(self, pending):
+        try:
+            try:
+                res_l = self._impl([p[0] for p in pending])
+                if inspect.isawaitable(res_l):
+                    res_l = await res_l
+                if res_l is None:
+                    res_l = [None]*len(pending)
+                elif len(res_l) != len(pending):
+                    raise Exception("Target call %s returned %d results for %d calls" % (
+                        self.name, len(res_l), len(pending)))
+            except Exception as e:
+                for _,future in pending:
+                    if not future.done():
+                        future.set_exception(e)
+                return
+            for (_,future),res in zip(pending, res_l):
+                if not future.done():
+                    future.set_result(res)
+        finally:
+            # Eg the task was cancelled, or 'impl' raised a BaseException.
+            # Callers must not wait on the batch forever
+            for _,future in pending:
+                if not future.done():
+                    future.cancel()
@@ -12,6 +12,9 @@ from .exec_group import ExecGroup
 from .constraint_impl import ConstraintImpl
 from .exec_type import ExecType
 from .method_proxy_fn import MethodProxyFn
+from .debug import Debug
+
+_dbg = Debug.get("typeinfo")
 
 class TypeInfo(vsc_impl.TypeInfoRandClass):
     
@@ -38,7 +41,8 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
         self._function_l : List[MethodProxyFn] = []
 
     def addExec(self, exec_t : ExecType):
-        print("TypeInfo.addExec")
+        if _dbg.en:
+            _dbg.debug("TypeInfo.addExec")
         if exec_t.kind not in self._exec_m.keys():
             self._exec_m[exec_t.kind] = ExecGroup(exec_t.kind)
         self._exec_m[exec_t.kind].add_exec(exec_t)
@@ -93,11 +97,13 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
 
         ctxt = Ctor.inst().ctxt()
         for kind in self._exec_m.keys():
-            print("Elaborating exec-kind %s" % str(kind))
+            if _dbg.en:
+                _dbg.debug("Elaborating exec-kind %s" % str(kind))
             root_scope = None
             scope = None
             for e in self._exec_m[kind].execs:
-                print("  Exec %s" % str(e))
+                if _dbg.en:
+                    _dbg.debug("  Exec %s" % str(e))
                 if scope is not None:
                     if root_scope is None:
                         root_scope = ctxt.mkTypeProcStmtScope()
@@ -143,7 +149,8 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
 
             ctor = vsc_impl.Ctor.inst()
 
-            print("f: %s" % str(f))
+            if _dbg.en:
+                _dbg.debug("f: %s" % str(f))
             
             # The signature of a creation function is:
             # - name
@@ -154,11 +161,13 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
             elif issubclass(t, PoolT):
                 self._elabFieldPool(f, attr, t)
             elif issubclass(t, LockShareT):
-                print("LockShare!")
+                if _dbg.en:
+                    _dbg.debug("LockShare!")
                 self._elabFieldLockShare(f, attr, t)
             elif hasattr(t, "_typeinfo") and isinstance(t._typeinfo, TypeInfo):
                 # This is a field of user-defined type
-                print("Has TypeInfo")
+                if _dbg.en:
+                    _dbg.debug("Has TypeInfo")
                 field_t = ctor.ctxt().mkTypeFieldPhy(
                     f.name, 
                     t._typeinfo.lib_obj,
@@ -168,19 +177,22 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
                 self.lib_obj.addField(field_t)
                 self._field_ctor_l.append((f.name, lambda name, t=t: t._createInst(t, name)))
                 
-            print("Field: %s" % str(f))
+            if _dbg.en:
+                _dbg.debug("Field: %s" % str(f))
             
     def _elabFieldLockShare(self, f, attr, t):
         ctor = vsc_impl.Ctor.inst()
         
         if hasattr(t.T, "_typeinfo"):
-            print("Kind: %s" % str(t.T._typeinfo._kind))
+            if _dbg.en:
+                _dbg.debug("Kind: %s" % str(t.T._typeinfo._kind))
             claim_t = t.T._typeinfo.lib_obj
         else:
             raise Exception("Type %s is not a PyRctGen type" % t.T.__qualname__)
         
         if f.default is not dataclasses.MISSING:
-            print("default: %s" % str(f.default))
+            if _dbg.en:
+                _dbg.debug("default: %s" % str(f.default))
             raise Exception("Lock/Share fields cannot be assigned a value")
         
         field_t = ctor.ctxt().mkTypeFieldClaim(
@@ -198,7 +210,8 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
         pool_t = None
         
         if hasattr(t.T, "_typeinfo"):
-            print("Kind: %s" % str(t.T._typeinfo._kind))
+            if _dbg.en:
+                _dbg.debug("Kind: %s" % str(t.T._typeinfo._kind))
             pool_t = t.T._typeinfo.lib_obj
         else:
             raise Exception("Type %s is not a PyRctGen type" % t.T.__qualname__)
@@ -254,12 +267,14 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
         return getattr(info, vsc_impl.TypeInfoRandClass.ATTR_NAME)
 
     def createHook(self, obj):
-        print("TypeInfo: createHook")
+        if _dbg.en:
+            _dbg.debug("TypeInfo: createHook")
         ctor = vsc_impl.Ctor.inst()
 
         s = ctor.scope()
 
-        print("createHook: %s %s" % (str(obj), str(s)))
+        if _dbg.en:
+            _dbg.debug("createHook: %s %s" % (str(obj), str(s)))
 
         if s is None:
             # Push a scope with the backend object
@@ -267,5 +282,6 @@ class TypeInfo(vsc_impl.TypeInfoRandClass):
             # pop this scope on exit
             ctor.push_scope(None, obj, False)
             inst = self.info.Tp()
-            print("createHook: id=%x" % id(inst), flush=True)
+            if _dbg.en:
+                _dbg.debug("createHook: id=%x" % id(inst))
             obj.setFieldData(inst)
@@ -3,7 +3,11 @@ import vsc_dataclasses.impl as vsc_impl
 
 from .ctor import Ctor, CtxtE
 from .modelinfo_activity import ModelinfoActivity
+from .obj_pool import ObjPool
 from .type_info import TypeInfo
+from .debug import Debug
+
+_dbg = Debug.get("typeinfo")
 
 class TypeInfoAction(TypeInfo):
 
@@ -12,18 +16,23 @@ class TypeInfoAction(TypeInfo):
         self.activities = []
         self.activity_super = None
         self._component_ti = None
+        # Released facades, available to back new action objects
+        self._facade_pool = ObjPool(reset_f=lambda inst, obj: TypeInfoAction.rebind(inst._modelinfo, obj))
+        self._claim_l = None
 
     def init(self, obj, args, kwargs, modelinfo=None, ctxt_b=None):
         ctor_a = Ctor.inst()
         ctor_vsc = vsc_impl.Ctor.inst()
-        print("==> Action.init %s %d" % (self.info.T.__name__, len(ctor_vsc._scope_s)))
+        if _dbg.en:
+            _dbg.debug("==> Action.init %s %d" % (self.info.T.__name__, len(ctor_vsc._scope_s)))
 
         if ctxt_b is None:
             ctxt_b = ctor_vsc.ctxt().mkModelBuildContext(Ctor.inst().ctxt())
 
         super().init(obj, args, kwargs, modelinfo, ctxt_b)
 
-        print("<== Action.init %s %d" % (self.info.T.__name__, len(ctor_vsc._scope_s)))
+        if _dbg.en:
+            _dbg.debug("<== Action.init %s %d" % (self.info.T.__name__, len(ctor_vsc._scope_s)))
 
     @property
     def component_ti(self):
@@ -37,17 +46,55 @@ class TypeInfoAction(TypeInfo):
         self._field_typeinfo[0].typeinfo.setComponentTi(v)
 
     def elab(self, obj):
-        print("TypeInfoAction.elab")
-        print("Field[0]=%s" % self.lib_typeobj.getField(0).name())
+        if _dbg.en:
+            _dbg.debug("TypeInfoAction.elab")
+            _dbg.debug("Field[0]=%s" % self.lib_typeobj.getField(0).name())
         self.lib_typeobj.setComponentType(self.component_ti.lib_typeobj)
-        print("Field[0]=%s" % self.lib_typeobj.getField(0).name())
+        if _dbg.en:
+            _dbg.debug("Field[0]=%s" % self.lib_typeobj.getField(0).name())
         super().elab(obj)
-        print("Field[0]=%s" % self.lib_typeobj.getField(0).name())
+        if _dbg.en:
+            _dbg.debug("Field[0]=%s" % self.lib_typeobj.getField(0).name())
 
         self.elabActivities(obj)
-        print("Field[0]=%s" % self.lib_typeobj.getField(0).name())
+        if _dbg.en:
+            _dbg.debug("Field[0]=%s" % self.lib_typeobj.getField(0).name())
         pass
 
+    def createHook(self, obj):
+        inst = None
+        if Ctor.inst().reuse_actions and vsc_impl.Ctor.inst().scope() is None:
+            # Rebinding a released facade saves constructing a facade
+            # (and its field facades) for each traversal
+            inst = self._facade_pool.take(obj)
+        if inst is not None:
+            obj.setFieldData(inst)
+        else:
+            super().createHook(obj)
+
+    def release(self, inst):
+        """Makes the facade of a completed action available for reuse"""
+        self._facade_pool.release(inst)
+
+    @staticmethod
+    def rebind(mi, libobj):
+        """Points a facade, and its field facades, at a new model object"""
+        mi.libobj = libobj
+        for v in object.__getattribute__(mi.obj, "__dict__").values():
+            sub_mi = getattr(v, "_modelinfo", None)
+            if sub_mi is not None and sub_mi is not mi and sub_mi._parent is mi and sub_mi._idx >= 0:
+                TypeInfoAction.rebind(sub_mi, libobj.getField(sub_mi._idx))
+
+    @property
+    def claims(self):
+        """(field index, TypeInfoClaim) for each lock/share claim"""
+        if self._claim_l is None:
+            from .typeinfo_claim import TypeInfoClaim
+            self._claim_l = list(filter(
+                lambda c: isinstance(c[1], TypeInfoClaim),
+                enumerate(self._field_typeinfo)))
+        return self._claim_l
+
     def addActivity(self, activity_t):
         self.activities.append(activity_t)
 
@@ -56,7 +103,8 @@ class TypeInfoAction(TypeInfo):
         modelinfo_p,
         name,
         idx):
-        print("TypeInfoAction::createInst")
+        if _dbg.en:
+            _dbg.debug("TypeInfoAction::createInst")
         ctor = vsc_impl.Ctor.inst()
         ctor.push_scope(
             None, 
@@ -84,7 +132,8 @@ class TypeInfoAction(TypeInfo):
         for a in self.activities:
             activity_s = ctor_a.ctxt().mkDataTypeActivitySequence()
             activity_mi = ModelinfoActivity(activity_s)
-            print("activity_s: %s" % str(activity_s))
+            if _dbg.en:
+                _dbg.debug("activity_s: %s" % str(activity_s))
             activity_f = ctor_a.ctxt().mkTypeFieldActivity(
                     "activity",
                     activity_s,
@@ -92,12 +141,15 @@ class TypeInfoAction(TypeInfo):
 
             # Add the activity to the action's type object
             self.lib_typeobj.addActivity(activity_f)
-            print("activity index=%d" % activity_f.getIndex())
+            if _dbg.en:
+                _dbg.debug("activity index=%d" % activity_f.getIndex())
             
             ctor_a.push_activity_scope_mi(activity_mi)
-            print("--> activity")
+            if _dbg.en:
+                _dbg.debug("--> activity")
             a.func(obj)
-            print("<-- activity %d", len(activity_s.getActivities()))
+            if _dbg.en:
+                _dbg.debug("<-- activity %d", len(activity_s.getActivities()))
             ctor_a.pop_activity_scope_mi()
 
         ctor.pop_type_mode()
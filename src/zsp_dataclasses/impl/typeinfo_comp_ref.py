@@ -1,5 +1,8 @@
 
 import vsc_dataclasses.impl as vsc_impl
+from .debug import Debug
+
+_dbg = Debug.get("typeinfo")
 
 class TypeInfoCompRef(vsc_impl.TypeInfoRef):
 
@@ -17,7 +20,8 @@ class TypeInfoCompRef(vsc_impl.TypeInfoRef):
             modelinfo_p, 
             name, 
             idx):
-        print("==> TypeInfoCompRef.createInst")
+        if _dbg.en:
+            _dbg.debug("==> TypeInfoCompRef.createInst")
         ctor = vsc_impl.Ctor.inst()
 
         if ctor.is_type_mode():
@@ -29,5 +33,6 @@ class TypeInfoCompRef(vsc_impl.TypeInfoRef):
             ret = field
         else:
             ret = super().createInst(modelinfo_p, name, idx)
-        print("<== TypeInfoCompRef.createInst")
+        if _dbg.en:
+            _dbg.debug("<== TypeInfoCompRef.createInst")
         return ret
\ No newline at end of file
@@ -19,10 +19,14 @@
 #*     Author: 
 #*
 #****************************************************************************
+import dataclasses
+import typeworks
 import vsc_dataclasses.impl as vsc_impl
 import vsc_dataclasses.impl.context as vsc_ctxt
 from vsc_dataclasses.impl.ctor import Ctor as VscCtor
+import zsp_dataclasses.impl.context as ctxt_api
 
+from .lazy_component_field import LazyComponentField
 from .modelinfo_component import ModelInfoComponent
 
 from .rt_ctxt import RtCtxt
@@ -30,12 +34,22 @@ from .ctor import Ctor
 from .exec_group import ExecGroup
 from .exec_kind_e import ExecKindE
 from .type_info import TypeInfo
+from .debug import Debug
+
+_dbg = Debug.get("typeinfo")
 
 class TypeInfoComponent(TypeInfo):
 
     def __init__(self, info):
         super().__init__(info)
         self._action_t = []
+        # Type object used to elaborate actions registered after
+        # the component itself was elaborated
+        self._elab_obj = None
+        # Whether this component, or any subcomponent, has init execs
+        self._has_init_execs = None
+        # Exec kind to closures shared by all instances (see shared_init)
+        self._shared_init_m = {}
 
     def init(self, 
         obj, 
@@ -44,11 +58,13 @@ class TypeInfoComponent(TypeInfo):
         modelinfo=None,
         ctxt_b=None):
         vsc_ctor = vsc_impl.Ctor.inst()
-        print("== Component.init.entry %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
+        if _dbg.en:
+            _dbg.debug("== Component.init.entry %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
         is_type_mode = vsc_ctor.is_type_mode()
         Ctor.inst().elab()
 
-        print("==> Component.init %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
+        if _dbg.en:
+            _dbg.debug("==> Component.init %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
 
         if modelinfo is None:
             modelinfo = ModelInfoComponent(obj, "<>", self)
@@ -57,15 +73,18 @@ class TypeInfoComponent(TypeInfo):
             ctxt_b = vsc_ctor.ctxt().mkModelBuildContext(Ctor.inst().ctxt())
 
         obj.backend = None
+        obj.eval_listeners = []
         obj.isInit = False
 
         super().init(obj, args, kwargs, modelinfo, ctxt_b)
 
         s = vsc_ctor.scope()
-        if s is None and not is_type_mode:
-            print("TODO: call initialization sequence")
+        if s is None and not is_type_mode and Ctor.inst()._materialize_depth == 0:
+            if _dbg.en:
+                _dbg.debug("TODO: call initialization sequence")
             self._runInitSeq(obj)
-        print("<== Component.init %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
+        if _dbg.en:
+            _dbg.debug("<== Component.init %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
 
     def createInst(
             self,
@@ -78,21 +97,73 @@ class TypeInfoComponent(TypeInfo):
         # we always need to provide a Field (ModelField/TypeField) as the 
         # parent. 
 
-        print("TypeInfoComponent.createInst: pre-size: %d" % len(vsc_ctor._scope_s))
+        if Ctor.inst().lazy_comp and not vsc_ctor.is_type_mode():
+            # Elaboration always needs the facades. Otherwise, the native 
+            # model backs the subcomponent until it is accessed
+            lz = LazyComponentField(
+                self, 
+                modelinfo_p, 
+                name, 
+                idx, 
+                len(modelinfo_p.component_fields))
+            modelinfo_p.addLazySubComponent(lz)
+            return lz
+
+        field = self._mkInst(modelinfo_p, name, idx)
+
+        if _dbg.en:
+            _dbg.debug("TODO: Add component-type field differently")
+        modelinfo_p.addSubComponent(field._modelinfo)
+
+        return field
+
+    def materialize(self, lz):
+        """Creates the facade for a lazy subcomponent. The tree's
+        initialization sequence has already run, so it isn't run again
+        for the new facade"""
+        if _dbg.en:
+            _dbg.debug("Materialize %s" % lz._lz_name)
+        ctor = Ctor.inst()
+        ctor._materialize_depth += 1
+        try:
+            field = self._mkInst(lz._lz_modelinfo_p, lz._lz_name, lz._lz_idx)
+        finally:
+            ctor._materialize_depth -= 1
+        lz._lz_modelinfo_p.resolveLazySubComponent(lz, field._modelinfo)
+        return field
+
+    def _mkInst(self, modelinfo_p, name, idx):
+        vsc_ctor = vsc_impl.Ctor.inst()
+        if _dbg.en:
+            _dbg.debug("TypeInfoComponent.createInst: pre-size: %d" % len(vsc_ctor._scope_s))
         vsc_ctor.push_scope(None, modelinfo_p.libobj.getField(idx), vsc_ctor.is_type_mode())
         field = self.info.Tp()
-        print("TypeInfoComponent.createInst: post-size: %d" % len(vsc_ctor._scope_s))
+        if _dbg.en:
+            _dbg.debug("TypeInfoComponent.createInst: post-size: %d" % len(vsc_ctor._scope_s))
 
         field._modelinfo.name = name
         field._modelinfo.idx = idx
-
-        print("TODO: Add component-type field differently")
-        modelinfo_p.addSubComponent(field._modelinfo)
-
         return field
 
+    @property
+    def has_init_execs(self):
+        """Whether initialization needs a facade for this subtree"""
+        if self._has_init_execs is None:
+            self._has_init_execs = False
+            if ExecKindE.InitDown in self._exec_m.keys() or ExecKindE.InitUp in self._exec_m.keys():
+                self._has_init_execs = True
+            else:
+                for f in dataclasses.fields(self.info.Tp):
+                    f_ti = typeworks.TypeInfo.get(f.type, False) if isinstance(f.type, type) else None
+                    f_ti = TypeInfo.get(f_ti, False) if f_ti is not None else None
+                    if isinstance(f_ti, TypeInfoComponent) and f_ti.has_init_execs:
+                        self._has_init_execs = True
+                        break
+        return self._has_init_execs
+
     def _runInitSeq(self, obj):
-        print("_runInitSeq")
+        if _dbg.en:
+            _dbg.debug("_runInitSeq")
         # TODO: invoke initialization methods
         obj._modelinfo.libobj.initCompTree()
         self._invokeInit(obj)
@@ -105,23 +176,33 @@ class TypeInfoComponent(TypeInfo):
         typeinfo : TypeInfoComponent = obj._modelinfo._typeinfo
 
         if ExecKindE.InitDown in typeinfo._exec_m.keys():
-            print("Component has InitDown")
-            exec_g : ExecGroup = typeinfo._exec_m[ExecKindE.InitDown]
-
-            ctxt.push_exec_group(exec_g)
-            for e in exec_g.execs:
-                # Push stmt scope to put 
-                print("--> push_proc_scope")
-                ctor.push_proc_scope(None)
-                e.func(obj)
-                ctor.pop_proc_scope()
-                print("<-- pop_proc_scope")
-
-#                for le in vsc_ctor.pop_expr()
-            ctxt.pop_exec_group()
-
-        for comp_mi in obj._modelinfo.component_fields:
-            print("comp_mi: %s" % comp_mi.name)
+            if _dbg.en:
+                _dbg.debug("Component has InitDown")
+            if not (ctor.shared_init and typeinfo._runSharedInit(ExecKindE.InitDown, obj)):
+                exec_g : ExecGroup = typeinfo._exec_m[ExecKindE.InitDown]
+
+                ctxt.push_exec_group(exec_g)
+                for e in exec_g.execs:
+                    # Push stmt scope to put 
+                    if _dbg.en:
+                        _dbg.debug("--> push_proc_scope")
+                    ctor.push_proc_scope(None)
+                    e.func(obj)
+                    ctor.pop_proc_scope()
+                    if _dbg.en:
+                        _dbg.debug("<-- pop_proc_scope")
+
+#                    for le in vsc_ctor.pop_expr()
+                ctxt.pop_exec_group()
+
+        for comp_mi in list(obj._modelinfo.component_fields):
+            if isinstance(comp_mi, LazyComponentField):
+                if not comp_mi._lz_ti.has_init_execs:
+                    # Nothing to run. Leave the facade deferred
+                    continue
+                comp_mi = comp_mi.materialize()._modelinfo
+            if _dbg.en:
+                _dbg.debug("comp_mi: %s" % comp_mi.name)
             self._invokeInit(comp_mi.obj)
 
         # for fn in dir(obj):
@@ -134,29 +215,128 @@ class TypeInfoComponent(TypeInfo):
         #                 print("Is a component")
 
         if ExecKindE.InitUp in typeinfo._exec_m.keys():
-            print("Component has InitUp")
-            exec_g : ExecGroup = typeinfo._exec_m[ExecKindE.InitUp]
-
-            ctxt.push_exec_group(exec_g)
-            for e in exec_g.execs:
-                e.func(obj)
-            ctxt.pop_exec_group()
+            if _dbg.en:
+                _dbg.debug("Component has InitUp")
+            if not (ctor.shared_init and typeinfo._runSharedInit(ExecKindE.InitUp, obj)):
+                exec_g : ExecGroup = typeinfo._exec_m[ExecKindE.InitUp]
+
+                ctxt.push_exec_group(exec_g)
+                for e in exec_g.execs:
+                    e.func(obj)
+                ctxt.pop_exec_group()
+
+    def _runSharedInit(self, kind, obj):
+        """Runs the 'kind' execs of this type against the model of 'obj'.
+        The closures are built on first use, from the exec IR captured 
+        when the type was elaborated. Returns False when the IR can't be
+        run without the Python body (eg it calls an import function), in
+        which case the caller runs the Python body"""
+        fn_l = self._shared_init_m.get(kind, None)
+        if fn_l is None:
+            from .exec_interp import ExecInterp
+            kind_t = {
+                ExecKindE.InitDown : ctxt_api.ExecKindT.InitDown,
+                ExecKindE.InitUp : ctxt_api.ExecKindT.InitUp
+            }[kind]
+            interp = ExecInterp()
+            fn_l = []
+            for e in self.lib_typeobj.getExecs():
+                if e.getKind() != kind_t:
+                    continue
+                # No call handler is available during construction (eg
+                # for reg-group set_handle), so execs that call functions
+                # without a body need the Python body
+                fn = None
+                if not ExecInterp.needsCall(e.getBody()):
+                    try:
+                        fn = interp.build(e.getBody())
+                    except Exception as ex:
+                        if _dbg.en:
+                            _dbg.debug("Exec IR not supported: %s" % str(ex))
+                if fn is None:
+                    if _dbg.en:
+                        _dbg.debug("Shared %s execs unsupported for %s" % (
+                            str(kind), self.info.T.__name__))
+                    fn_l = False
+                    break
+                fn_l.append(fn)
+            if fn_l is not False and len(fn_l) > 0 and Ctor.inst().compile_execs:
+                fn_l = self._compileInit(kind_t, fn_l)
+            self._shared_init_m[kind] = fn_l
+            if _dbg.en and fn_l is not False:
+                _dbg.debug("Built %d shared %s execs for %s" % (
+                    len(fn_l), str(kind), self.info.T.__name__))
+
+        if fn_l is False:
+            return False
+        libobj = obj._modelinfo.libobj
+        for fn in fn_l:
+            fn(libobj)
+        return True
+
+    def _compileInit(self, kind_t, fn_l):
+        """Returns callables that run the compiled 'kind_t' execs of this
+        type. Returns the closures in 'fn_l' when the execs of the type
+        can't be lowered to C++"""
+        from .exec_compiler import ExecModelRunner
+        from .generators.exec_cpp_gen import ExecCppGen
+        ctor = Ctor.inst()
+        try:
+            src = ExecCppGen().generate(
+                [self.lib_typeobj], 
+                ctor.ctxt().getDataTypeFunctions())
+        except Exception as ex:
+            if _dbg.en:
+                _dbg.debug("Execs of %s not lowered: %s" % (self.info.T.__name__, str(ex)))
+            return fn_l
+
+        # Both init kinds come from the same source, and thus library
+        runner = ExecModelRunner(ctor.execCompiler().compile(src), self.lib_typeobj)
+        ret = []
+        for ii in range(len(fn_l)):
+            ret.append(runner.mkRun("%s::%s_%d" % (
+                self.lib_typeobj.name(), ExecCppGen.EXEC_KIND_M[kind_t], ii)))
+        if _dbg.en:
+            _dbg.debug("Compiled %d %s execs for %s" % (
+                len(ret), str(kind_t), self.info.T.__name__))
+        return ret
 
     def elab(self, obj=None):
         vsc_ctor = vsc_impl.Ctor.inst()
-        print("--> TypeInfoComponent.elab %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
+        if _dbg.en:
+            _dbg.debug("--> TypeInfoComponent.elab %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
         if obj is None:
-            print("Create object")
+            if _dbg.en:
+                _dbg.debug("Create object")
             # Push the data-type object for the component
-            print("pre-create object %d" % len(vsc_ctor._scope_s))
+            if _dbg.en:
+                _dbg.debug("pre-create object %d" % len(vsc_ctor._scope_s))
             obj = self.createTypeInst()
 #            vsc_ctor.push_scope(None, self.lib_typeobj, True)
 #            obj = self.elab_obj_ctor()
 #            vsc_ctor.pop_scope()
-            print("post-create object %d" % len(vsc_ctor._scope_s))
+            if _dbg.en:
+                _dbg.debug("post-create object %d" % len(vsc_ctor._scope_s))
 
         # Elab the component first
         super().elab(obj)
+        self._elab_obj = obj
+
+        self._elabActions(obj)
+
+        if _dbg.en:
+            _dbg.debug("<-- TypeInfoComponent.elab %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
+
+    @property
+    def has_pending_actions(self):
+        return any(not a.is_elab for a in self._action_t)
+
+    def elabPendingActions(self):
+        """Elaborates actions registered after the component was elaborated"""
+        self._elabActions(self._elab_obj)
+
+    def _elabActions(self, obj):
+        vsc_ctor = vsc_impl.Ctor.inst()
 
         # Since a lot of the 'fun' happens during elab, 
         # perhaps we should just have the component on a higher
@@ -165,19 +345,21 @@ class TypeInfoComponent(TypeInfo):
         vsc_ctor.push_scope(obj, None, True) # We're definitely in type mode
         # Then, elab each of the actions
         for action_t in self._action_t:
+            if action_t.is_elab:
+                continue
             # The action must know the component type prior to
             # constructing the elaboration object
             action_t.component_ti = self
 
-            print("--> Elab action %s %d" % (action_t.info.Tp.__name__, len(vsc_ctor._scope_s)))
+            if _dbg.en:
+                _dbg.debug("--> Elab action %s %d" % (action_t.info.Tp.__name__, len(vsc_ctor._scope_s)))
 #            obj_a = action_t.elab_obj_ctor()
             obj_a = action_t.createTypeInst()
             action_t.elab(obj_a)
-            print("<-- Elab action %s %d" % (action_t.info.Tp.__name__, len(vsc_ctor._scope_s)))
+            if _dbg.en:
+                _dbg.debug("<-- Elab action %s %d" % (action_t.info.Tp.__name__, len(vsc_ctor._scope_s)))
         vsc_ctor.pop_scope()
 
-        print("<-- TypeInfoComponent.elab %s %d" % (self.info.T.__name__, len(vsc_ctor._scope_s)))
-
     def addActionT(self, a):
         self._action_t.append(a)
         # Register with the backend component-type object
@@ -190,5 +372,6 @@ class TypeInfoComponent(TypeInfo):
         return getattr(info, vsc_impl.TypeInfoRandClass.ATTR_NAME)
 
     def createHook(self, obj):
-        print("Note: skip Component createHook")
+        if _dbg.en:
+            _dbg.debug("Note: skip Component createHook")
         pass
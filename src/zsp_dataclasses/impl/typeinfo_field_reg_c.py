@@ -20,17 +20,23 @@
 #*
 #****************************************************************************
 from vsc_dataclasses.impl.typeinfo_field import TypeInfoField
+from .field_reg_array_impl import FieldRegArrayImpl
 from .field_reg_c_impl import FieldRegCImpl
 
 class TypeInfoFieldRegC(TypeInfoField):
 
-    def __init__(self, name, typeinfo):
+    def __init__(self, name, typeinfo, count=0):
         super().__init__(name, typeinfo)
+        self.count = count
 
     def createInst(
         self,
         modelinfo_p,
         name,
         idx):
-        return FieldRegCImpl(modelinfo_p, name, idx)
+        if self.count > 0:
+            return FieldRegArrayImpl(
+                modelinfo_p, name, idx, self.typeinfo.lib_typeobj, self.count)
+        else:
+            return FieldRegCImpl(modelinfo_p, name, idx, self.typeinfo.lib_typeobj)
 
@@ -0,0 +1,144 @@
+#****************************************************************************
+#* with_c_precompiler.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import vsc_dataclasses.impl.context as vsc_ctxt
+from .debug import Debug
+
+_dbg = Debug.get("activity")
+
+class WithCPlan(object):
+    """Result of precompiling a with-clause. 'assign_m' maps the field
+    references fixed to a value to that value. 'domain_m' maps range-bound
+    references to (lo, hi), where a missing bound is None. 'keep_l' holds
+    the indices of the expressions that must still be solved. The maps
+    describe the kept terms; nothing consumes them in place of solving"""
+    __slots__ = ("assign_m", "domain_m", "keep_l", "unsat_l")
+
+    def __init__(self):
+        self.assign_m = {}
+        self.domain_m = {}
+        self.keep_l = []
+        self.unsat_l = []
+
+class WithCPrecompiler(object):
+    """Recognizes with-clause terms that compare a field with a constant
+    ('f == 4', 'f < 16', '2 <= f'). All terms on a field reduce to either
+    a single assignment or a single domain. Terms implied by the others
+    (duplicate equalities, looser bounds, bounds implied by an equality)
+    are dropped. Other expressions, and all terms on a field whose terms
+    can't be satisfied together, are kept unchanged for the solver.
+
+    Constants are only recognized in the non-negative int64 range. The
+    IR holds them as signed 64-bit values, so a large unsigned constant
+    (eg 0xFFFFFFFFFFFFFFFF) reads as negative, and comparing it with
+    other bounds would drop terms that still constrain the field"""
+
+    # Normalized (ref OP value) form of (value OP ref)
+    FLIP_M = {"Eq" : "Eq", "Gt" : "Lt", "Ge" : "Le", "Lt" : "Gt", "Le" : "Ge"}
+
+    def precompile(self, expr_l) -> WithCPlan:
+        ret = WithCPlan()
+        term_l = list(map(self._term, expr_l))
+        keep = [True]*len(expr_l)
+
+        field_m = {}
+        for i,t in enumerate(term_l):
+            if t is not None:
+                field_m.setdefault(t[0], []).append(i)
+
+        for key,idx_l in field_m.items():
+            eq_i = None
+            eq_s = set()
+            lo = hi = None
+            lo_i = hi_i = None
+            for i in idx_l:
+                _,op,v = term_l[i]
+                if op == "Eq":
+                    eq_s.add(v)
+                    if eq_i is None:
+                        eq_i = i
+                elif op == "Ge":
+                    if lo is None or v > lo:
+                        lo, lo_i = v, i
+                else:
+                    if hi is None or v < hi:
+                        hi, hi_i = v, i
+
+            if (len(eq_s) > 1 or 
+                    (lo is not None and hi is not None and lo > hi) or
+                    (len(eq_s) == 1 and not self._inRange(next(iter(eq_s)), lo, hi))):
+                # Leave it to the solver to report the conflict
+                ret.unsat_l.append(key)
+                continue
+
+            if eq_i is not None:
+                ret.assign_m[key] = next(iter(eq_s))
+                keep_s = {eq_i}
+            else:
+                ret.domain_m[key] = (lo, hi)
+                keep_s = {lo_i, hi_i}
+            for i in idx_l:
+                keep[i] = (i in keep_s)
+
+        ret.keep_l = [i for i in range(len(expr_l)) if keep[i]]
+        if _dbg.en:
+            _dbg.debug("With-clause: %d terms, %d kept, %d assigned, %d narrowed, %d conflicting" % (
+                len(expr_l), len(ret.keep_l), len(ret.assign_m), 
+                len(ret.domain_m), len(ret.unsat_l)))
+        return ret
+
+    @staticmethod
+    def _inRange(v, lo, hi):
+        return (lo is None or v >= lo) and (hi is None or v <= hi)
+
+    def _term(self, e):
+        """Returns (ref key, 'Eq'|'Ge'|'Le', value) for a comparison of a
+        field with a constant, and None otherwise"""
+        if not isinstance(e, vsc_ctxt.TypeExprBin):
+            return None
+        op = e.op()
+        name = op.name if hasattr(op, "name") else str(op)
+        if name not in WithCPrecompiler.FLIP_M.keys():
+            return None
+        lhs, rhs = e.lhs(), e.rhs()
+        if isinstance(lhs, vsc_ctxt.TypeExprFieldRef) and isinstance(rhs, vsc_ctxt.TypeExprVal):
+            ref, val = lhs, rhs
+        elif isinstance(rhs, vsc_ctxt.TypeExprFieldRef) and isinstance(lhs, vsc_ctxt.TypeExprVal):
+            ref, val = rhs, lhs
+            name = WithCPrecompiler.FLIP_M[name]
+        else:
+            return None
+
+        v = val.val().val_i()
+        if v < 0:
+            # Possibly an unsigned constant of 2^63 or more. Leave the
+            # term to the solver
+            return None
+        key = (
+            ref.getRootRefKind(), 
+            ref.getRootRefOffset(), 
+            tuple(ref.at(i) for i in range(ref.size())))
+        if name == "Gt":
+            return (key, "Ge", v+1)
+        elif name == "Lt":
+            return (key, "Le", v-1)
+        else:
+            return (key, name, v)
@@ -27,6 +27,9 @@ from vsc_dataclasses.impl.ctor import Ctor as VscCtor
 from vsc_dataclasses.impl.field_scalar_impl import FieldScalarImpl
 from vsc_dataclasses.impl.typeinfo_scalar import TypeInfoScalar
 from .impl.ctor import Ctor, CtxtE
+from .impl.debug import Debug
+
+_dbg = Debug.get("activity")
 
 class if_then(object):
 
@@ -38,14 +41,17 @@ class if_then(object):
 
         cond_e = Expr.toExpr(e)
         ctor.pop_expr(cond_e)
-        print("Cond: %s" % str(cond_e.model))
+        if _dbg.en:
+            _dbg.debug("Cond: %s" % str(cond_e.model))
 
         # Have constraint, proc, and activity
         if ctxt_t == CtxtE.Activity:
-            print("Activity")
+            if _dbg.en:
+                _dbg.debug("Activity")
             pass
         elif ctxt_t == CtxtE.Constraint:
-            print("Constraint")
+            if _dbg.en:
+                _dbg.debug("Constraint")
             pass
         elif ctxt_t == CtxtE.Exec:
             scope = ctor_a.proc_scope()
@@ -71,10 +77,12 @@ class if_then(object):
 
         # Have constraint, proc, and activity
         if ctxt_t == CtxtE.Activity:
-            print("Activity")
+            if _dbg.en:
+                _dbg.debug("Activity")
             pass
         elif ctxt_t == CtxtE.Constraint:
-            print("Constraint")
+            if _dbg.en:
+                _dbg.debug("Constraint")
             pass
         elif ctxt_t == CtxtE.Exec:
             ctor_a.pop_proc_scope()
@@ -96,16 +104,19 @@ class else_if(object):
 
         # Have constraint, proc, and activity
         if ctxt_t == CtxtE.Activity:
-            print("Activity")
+            if _dbg.en:
+                _dbg.debug("Activity")
             pass
         elif ctxt_t == CtxtE.Constraint:
-            print("Constraint")
+            if _dbg.en:
+                _dbg.debug("Constraint")
             pass
         elif ctxt_t == CtxtE.Exec:
             scope = ctor_a.proc_scope()
             last = scope.getStatements()[-1]
 
-            print("Scope: %s" % str(last))
+            if _dbg.en:
+                _dbg.debug("Scope: %s" % str(last))
             if not isinstance(last, ctxt_api.TypeProcStmtIfElse):
                 raise Exception("Expecting to find TypeProcStmtIfElse, but found %s" % str(last))
             false_s = ctor_a.ctxt().mkTypeProcStmtScope()
@@ -144,16 +155,19 @@ class else_then_c(object):
         
         # Have constraint, proc, and activity
         if ctxt_t == CtxtE.Activity:
-            print("Activity")
+            if _dbg.en:
+                _dbg.debug("Activity")
             pass
         elif ctxt_t == CtxtE.Constraint:
-            print("Constraint")
+            if _dbg.en:
+                _dbg.debug("Constraint")
             pass
         elif ctxt_t == CtxtE.Exec:
             scope = ctor_a.proc_scope()
             last = scope.getStatements()[-1]
 
-            print("Scope: %s" % str(last))
+            if _dbg.en:
+                _dbg.debug("Scope: %s" % str(last))
             if not isinstance(last, ctxt_api.TypeProcStmtIfElse):
                 raise Exception("Expecting to find TypeProcStmtIfElse, but found %s" % str(last))
             false_s = ctor_a.ctxt().mkTypeProcStmtScope()
@@ -189,10 +203,12 @@ class else_then_c(object):
 
         # Have constraint, proc, and activity
         if ctxt_t == CtxtE.Activity:
-            print("Activity")
+            if _dbg.en:
+                _dbg.debug("Activity")
             pass
         elif ctxt_t == CtxtE.Constraint:
-            print("Constraint")
+            if _dbg.en:
+                _dbg.debug("Constraint")
             pass
         elif ctxt_t == CtxtE.Exec:
             ctor_a.pop_proc_scope()
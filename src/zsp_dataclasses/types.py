@@ -8,6 +8,7 @@ Created on Apr 26, 2022
 from vsc_dataclasses.types import *
 
 from .impl.bind_all_impl import BindAllImpl
+from .impl.buf_t import BufT, BufField
 from .impl.pool_meta_t import PoolMetaT
 
 #class pool(metaclass=PoolMetaT):
@@ -17,3 +18,12 @@ def bind_all():
     """Initiatlizer for a pool with a wildcard bind"""
     return BindAllImpl()
 
+def buf(size, typecode="B"):
+    """Declares a buffer attribute of 'size' items (bytes by default, or
+    an array.array typecode). Buffers are passed to import functions
+    without copying"""
+    return BufField(size, typecode)
+
+# Parameter type of import functions that take a buffer
+buf_t = BufT
+
@@ -19,6 +19,8 @@
 #*     Author: 
 #*
 #****************************************************************************
+import mmap
+import re
 from typing import List
 
 #
@@ -43,6 +45,12 @@ class DSLContent(object):
         self.content = content
 
 class ExtractCppEmbeddedDSL(object):
+    """Extracts embedded-DSL fragments from a C++ source. Files are
+    memory-mapped and searched for the macro name, such that files
+    without fragments are rejected without being decoded. Only the
+    macro invocations themselves are parsed"""
+
+    _macro_re_m = {}
 
     def __init__(self, 
             file_or_fp,
@@ -52,146 +60,148 @@ class ExtractCppEmbeddedDSL(object):
         if hasattr(file_or_fp, "read"):
             # This is a stream-like object
             self._fp = file_or_fp
+            self._path = None
             if name is None:
-                self._name = self._fp.name()
+                name = getattr(file_or_fp, "name", "<stream>")
         else:
-            self._fp = open(file_or_fp, "r")
-            self._name = file_or_fp
-        
-        self._lineno = 0
-        self._unget_ch = None
-        self._last_ch = None
-        self._buffer = ""
-        self._buffer_i = 0
+            self._fp = None
+            self._path = file_or_fp
+            if name is None:
+                name = file_or_fp
+        self._name = name
 
     def extract(self) -> List[DSLContent]:
-        ret = []
-
-        while self.find_macro():
-
-            lineno = self._lineno
-            while True:
-                ch = self.getch()
-
-                if ch is None or ch == '(':
-                    break
-
-            if ch is None:
-                raise Exception("Failed to parse embedded DSL @ %s:%d" % (self._name, self._lineno))
-            
-            # Now, collect the complete content of the macro
-            content = ""
-            count_b = 1
-            while count_b > 0:
-                ch = self.getch()
-
-                if ch is None:
-                    break
-                content += ch
-
-                if ch == '(':
-                    count_b += 1
-                elif ch == ')':
-                    count_b -= 1
-
-            if count_b > 0:
-                raise Exception("Unbalanced parens")
-            content = content[:-2]
-            
-            # We now have text from a macro invocation
-            start = 0
-            count_b = 0
-            params = []
-
-            for i in range(len(content)):
-                if content[i] == "," and count_b == 0:
-                    params.append(content[start:i].strip())
-                    start = i+1
-                elif content[i] == '(':
-                    count_b += 1
-                elif content[i] == ')':
-                    count_b -= 1
-
-            if count_b != 0:
-                raise Exception("Unbalanced parens while tokenizing") 
-
-            if start < len(content):
-                params.append(content[start:].strip())
-
-            if len(params) != 4:
-                raise Exception("Expected 3 params; received %d" % len(params))
-
-            if params[-1].startswith('R"('):
-                params[-1] = params[-1][3:-2]
-
-            content = params[-1].split("\n")
-            min_ws = 10000
-
-            for l in content:
-                l_strip = l.strip()
-                if l_strip != "":
-                    ws_l = len(l) - len(l_strip)
-                    if ws_l < min_ws:
-                        min_ws = ws_l
-
-            for i in range(len(content)):
-                content[i] = content[i][min_ws:]
-
-            vsc_content = "\n".join(content)
-
-            root_comp = params[1]
-            root_action = params[2]
-
-            info = DSLContent(params[0], root_comp, root_action, vsc_content)
-            ret.append(info)
-
-        self._fp.close()
+        if self._fp is not None:
+            text = self._fp.read()
+            self._fp.close()
+            if isinstance(text, bytes):
+                text = text.decode()
+            if text.find(self._macro_name) == -1:
+                return []
+        else:
+            text = self._read(self._path, self._macro_name.encode())
+            if text is None:
+                return []
+        return self._extractText(text)
+
+    @staticmethod
+    def _read(path, macro_b):
+        """Returns the text of 'path', or None if it can't contain a 
+        fragment"""
+        with open(path, "rb") as fp:
+            try:
+                mm = mmap.mmap(fp.fileno(), 0, access=mmap.ACCESS_READ)
+            except ValueError:
+                # Empty files can't be mapped
+                return None
+            with mm:
+                if mm.find(macro_b) == -1:
+                    return None
+                return mm[:].decode()
+
+    def _macroRe(self):
+        ret = ExtractCppEmbeddedDSL._macro_re_m.get(self._macro_name, None)
+        if ret is None:
+            # Matches invocations, but not the macro's definition
+            ret = re.compile(
+                r"^(?![ \t]*#[ \t]*define\b)(.*?)\b%s[ \t]*\(" % (
+                    re.escape(self._macro_name)),
+                re.MULTILINE)
+            ExtractCppEmbeddedDSL._macro_re_m[self._macro_name] = ret
         return ret
 
-    def find_macro(self):
-
+    def _extractText(self, text) -> List[DSLContent]:
+        ret = []
+        pos = 0
+        macro_re = self._macroRe()
         while True:
-            line = self._fp.readline()
-            self._lineno += 1
-
-            if line == "":
+            m = macro_re.search(text, pos)
+            if m is None:
                 break
-            
-            idx = line.find(self._macro_name)
-            
-            if idx >= 0:
-                self._buffer = line
-                self._buffer_i = idx + len(self._macro_name)
-                return True
-        
-        return False
-
-    def getch(self):
-        if self._buffer is None:
-            return None
-
-        if self._buffer_i >= len(self._buffer):
-            try:
-                self._buffer = self._fp.readline()
-                self._buffer_i = 0
-                self._lineno += 1
-                if self._buffer == "":
-                    self._buffer = None
-                    return None
-            except Exception:
-                self._buffer = None
-                return None
-            
-        ret = self._buffer[self._buffer_i]
-        self._buffer_i += 1
+            prefix = m.group(1)
+            if "//" in prefix or prefix.replace('\\"', '').count('"') % 2 == 1:
+                # Mentioned within a comment or string literal
+                pos = m.end()
+                continue
+            params, pos = self._parseParams(text, m.end())
+
+            if len(params) != 4:
+                raise Exception("Expected 4 params; received %d @ %s:%d" % (
+                    len(params), self._name, self._lineno(text, m.start())))
+
+            content = params[-1]
+            raw = ExtractCppEmbeddedDSL._RAW_RE.match(content)
+            if raw is not None:
+                delim = raw.group(1)
+                content = content[raw.end():-(len(delim)+2)]
+
+            ret.append(DSLContent(
+                params[0], 
+                params[1], 
+                params[2], 
+                ExtractCppEmbeddedDSL._dedent(content)))
         return ret
-    
-    def ungetch(self, ch):
-        if self._buffer is None:
-            self._buffer = ch
-        elif self._buffer_i > 0:
-            self._buffer_i -= 1
-            self._buffer[self._buffer_i] = ch
-        else:
-            self._buffer.insert(0, ch)
 
+    # Raw-string prefix: R"delim(
+    _RAW_RE = re.compile(r'R"([^()\\ \t\n]{0,16})\(')
+
+    def _parseParams(self, text, i):
+        """Splits the macro parameters starting at 'i' (just after the
+        open paren). Returns the parameters and the index after the
+        close paren. Raw strings and string literals are skipped whole,
+        such that parens and commas within them are ignored"""
+        params = []
+        start = i
+        depth = 1
+        n = len(text)
+        while i < n:
+            ch = text[i]
+            if ch == '"':
+                if i > 0 and text[i-1] == 'R':
+                    raw = ExtractCppEmbeddedDSL._RAW_RE.match(text, i-1)
+                    if raw is None:
+                        raise Exception("Malformed raw string @ %s:%d" % (
+                            self._name, self._lineno(text, i)))
+                    end = text.find(")%s\"" % raw.group(1), raw.end())
+                    if end == -1:
+                        raise Exception("Unterminated raw string @ %s:%d" % (
+                            self._name, self._lineno(text, i)))
+                    i = end + len(raw.group(1)) + 2
+                    continue
+                i += 1
+                while i < n and text[i] != '"':
+                    i += 2 if text[i] == '\\' else 1
+            elif ch == '(':
+                depth += 1
+            elif ch == ')':
+                depth -= 1
+                if depth == 0:
+                    params.append(text[start:i].strip())
+                    return (params, i+1)
+            elif ch == ',' and depth == 1:
+                params.append(text[start:i].strip())
+                start = i+1
+            i += 1
+        raise Exception("Unbalanced parens in %s @ %s:%d" % (
+            self._macro_name, self._name, self._lineno(text, start)))
+
+    @staticmethod
+    def _lineno(text, i):
+        return text.count("\n", 0, i) + 1
+
+    @staticmethod
+    def _dedent(content):
+        content = content.split("\n")
+        min_ws = 10000
+
+        for l in content:
+            l_strip = l.strip()
+            if l_strip != "":
+                ws_l = len(l) - len(l_strip)
+                if ws_l < min_ws:
+                    min_ws = ws_l
+
+        for i in range(len(content)):
+            content[i] = content[i][min_ws:]
+
+        return "\n".join(content)
@@ -23,79 +23,339 @@
 #****************************************************************************
 
 import argparse
+import filecmp
+import hashlib
+import json
+import multiprocessing
 import os
 import zsp_dataclasses as zdc
 from zsp_dataclasses.impl.ctor import Ctor
+from zsp_dataclasses.impl.debug import Debug
 from zsp_dataclasses.impl.pyctxt.context import Context
+from zsp_dataclasses.impl.generators.collect_type_deps import CollectTypeDeps
+from zsp_dataclasses.impl.generators.exec_cpp_gen import ExecCppGen
 from zsp_dataclasses.impl.generators.zsp_data_model_cpp_gen import ZspDataModelCppGen
 from ..extract_cpp_embedded_dsl import ExtractCppEmbeddedDSL
 
+CACHE_FILE = ".zspdefs_cache.json"
+
 def get_parser():
     parser = argparse.ArgumentParser()
     parser.add_argument("-o","--outdir", default="zspdefs",
         help="Specifies the output directory")
     parser.add_argument("-d", "--depfile",
-        help="Specifies a dependency file")
+        help="Specifies a dependency file. Lists the generated headers, and the source each came from")
+    parser.add_argument("-j", "--jobs", type=int, default=1,
+        help="Number of worker processes used to elaborate fragments (0: one per CPU)")
+    parser.add_argument("--reg-tables", action="store_true",
+        help="Emit register groups as static tables instead of per-register builder calls")
+    parser.add_argument("--dedup-types", action="store_true",
+        help="Emit structurally-identical struct types once, as a shared type")
+    parser.add_argument("--exec-src", action="store_true",
+        help="Also lower exec and function bodies to C++ functions (<fragment>_exec.cpp)")
+    parser.add_argument("--split", type=int, default=0,
+        help="Generate each fragment as up to N translation units (<fragment>_part<i>.cpp) and an index header")
+    parser.add_argument("--no-cache", action="store_true",
+        help="Ignore the fragment content-hash cache and regenerate all headers")
+    parser.add_argument("--debug",
+        help="Enables debug output for subsystems (eg 'typeinfo,gen=INFO' or '*')")
     parser.add_argument("files", nargs='+')
 
     return parser
 
+def get_version():
+    try:
+        from importlib.metadata import version
+        return version("zuspec-dataclasses")
+    except Exception:
+        return "unknown"
+
+def get_gen_opts(args):
+    """Collects the generator options. These affect the generated text,
+    and so are part of the cache key"""
+    return {
+        "reg_tables" : args.reg_tables,
+        "dedup_types" : args.dedup_types,
+        "exec_src" : args.exec_src,
+        "split" : args.split
+    }
+
+def fragment_hash(fragment, version, gen_opts):
+    """Computes the cache key for a fragment. Any change to the fragment
+    text, its root types, the generator options, or the zsp_dataclasses
+    version invalidates it"""
+    h = hashlib.sha256()
+    for v in (
+            version,
+            json.dumps(gen_opts, sort_keys=True),
+            fragment.name,
+            fragment.root_comp,
+            fragment.root_action,
+            fragment.content):
+        h.update(v.encode())
+        h.update(b"\0")
+    return h.hexdigest()
+
+def load_cache(outdir):
+    cache_path = os.path.join(outdir, CACHE_FILE)
+    if os.path.isfile(cache_path):
+        try:
+            with open(cache_path, "r") as fp:
+                return json.load(fp)
+        except Exception:
+            # A corrupted cache simply results in a full regeneration
+            pass
+    return {}
+
+def save_cache(outdir, cache):
+    cache_path = os.path.join(outdir, CACHE_FILE)
+    with open(cache_path + ".tmp", "w") as fp:
+        json.dump(cache, fp, indent=2, sort_keys=True)
+    os.replace(cache_path + ".tmp", cache_path)
+
+def gen_fragment(fragment, outdir, gen_opts, debug=None, jobs=1):
+    """Elaborates a single fragment in a fresh context and generates its
+    outputs. Returns (changed, outputs): whether any output content 
+    changed, and the names of the output files within 'outdir'. 
+    Module-level so it can run in a worker process. 'jobs' is the number
+    of processes used to generate the parts of a split fragment"""
+    if debug is not None:
+        # Spawned worker processes don't inherit settings applied at startup
+        Debug.configure(debug)
+    Ctor.init(Context())
+
+    print("--> Process Fragment %s" % fragment.name)
+    _globals = globals().copy()
+    exec(fragment.content, _globals)
+    print("<-- Process Fragment %s" % fragment.name)
+
+    Ctor.inst().elab()
+
+    root_comp = Ctor.inst().ctxt().findDataTypeComponent(fragment.root_comp)
+    if root_comp is None:
+        raise Exception("Failed to find root component %s" % fragment.root_comp)
+    root_action = Ctor.inst().ctxt().findDataTypeAction(fragment.root_action)
+    if root_action is None:
+        raise Exception("Failed to find root action %s" % fragment.root_action)
+
+    if gen_opts.get("split", 0) > 0:
+        changed, outputs = gen_split(fragment, outdir, gen_opts, root_comp, root_action, jobs)
+    else:
+        def gen_header(fp):
+            gen = ZspDataModelCppGen(
+                sink=fp, 
+                reg_tables=gen_opts["reg_tables"],
+                dedup_types=gen_opts["dedup_types"])
+            gen._ctxt = "m_ctxt"
+            gen.generate(
+                root_comp,
+                root_action,
+                Ctor.inst().ctxt().getDataTypeFunctions())
+
+        changed = write_if_changed(
+            os.path.join(outdir, "%s.h" % fragment.name),
+            gen_header)
+        outputs = ["%s.h" % fragment.name]
+        # Parts from an earlier split run would otherwise linger
+        changed |= remove_parts(outdir, fragment.name, 0)
+
+    if gen_opts.get("exec_src", False):
+        def gen_exec(fp):
+            ExecCppGen(sink=fp).generate(
+                CollectTypeDeps().collect(root_comp, root_action),
+                Ctor.inst().ctxt().getDataTypeFunctions())
+        changed |= write_if_changed(
+            os.path.join(outdir, "%s_exec.cpp" % fragment.name),
+            gen_exec)
+        outputs.append("%s_exec.cpp" % fragment.name)
+
+    return (changed, outputs)
+
+def gen_split(fragment, outdir, gen_opts, root_comp, root_action, jobs):
+    """Writes the index header and parts of a split fragment, and removes
+    parts left over from an earlier run with more parts. Returns
+    (changed, outputs)"""
+    gen = ZspDataModelCppGen(
+        reg_tables=gen_opts["reg_tables"],
+        dedup_types=gen_opts["dedup_types"])
+    gen._ctxt = "m_ctxt"
+    out_l = gen.generateSplit(
+        fragment.name,
+        root_comp,
+        root_action,
+        Ctor.inst().ctxt().getDataTypeFunctions(),
+        n_parts=gen_opts["split"],
+        jobs=jobs)
+
+    changed = False
+    for fname,text in out_l:
+        changed |= write_if_changed(
+            os.path.join(outdir, fname),
+            lambda fp, text=text: fp.write(text))
+
+    # The first entry is the index header
+    changed |= remove_parts(outdir, fragment.name, len(out_l)-1)
+    return (changed, [fname for fname,_ in out_l])
+
+def remove_parts(outdir, name, first):
+    """Removes the split parts of fragment 'name', starting at part 
+    'first'. Returns True if any were removed"""
+    removed = False
+    pi = first
+    while True:
+        path = os.path.join(outdir, "%s_part%d.cpp" % (name, pi))
+        if not os.path.isfile(path):
+            break
+        os.remove(path)
+        removed = True
+        pi += 1
+    return removed
+
+def write_if_changed(path, gen_f):
+    """Streams generated text to a temporary file, then only replaces the
+    existing file when the content differs. This preserves the timestamp
+    of unchanged outputs, and avoids triggering downstream C++ recompiles"""
+    tmp_path = "%s.%d.tmp" % (path, os.getpid())
+    try:
+        with open(tmp_path, "w") as fp:
+            gen_f(fp)
+    except Exception:
+        os.remove(tmp_path)
+        raise
+
+    if os.path.isfile(path) and filecmp.cmp(tmp_path, path, shallow=False):
+        os.remove(tmp_path)
+        return False
+    else:
+        os.replace(tmp_path, path)
+        return True
+
+def read_depfile(path):
+    """Returns the {source: [outputs]} recorded in depfile 'path'"""
+    ret = {}
+    if path is None or not os.path.isfile(path):
+        return ret
+    with open(path, "r") as fp:
+        for line in fp:
+            target, sep, src = line.rpartition(": ")
+            if sep == "":
+                continue
+            ret.setdefault(unescape_dep(src.strip()), []).append(unescape_dep(target))
+    return ret
+
+def write_depfile(path, dep_m):
+    """Writes a Make-syntax depfile with a rule per generated file, 
+    naming the source the fragment was extracted from"""
+    with open(path + ".tmp", "w") as fp:
+        for src in sorted(dep_m.keys()):
+            for out in dep_m[src]:
+                fp.write("%s: %s\n" % (escape_dep(out), escape_dep(src)))
+    os.replace(path + ".tmp", path)
+
+def escape_dep(path):
+    return path.replace(" ", "\\ ")
+
+def unescape_dep(path):
+    return path.replace("\\ ", " ")
+
+def gen_fragment_w(args):
+    return gen_fragment(*args)
+
 def main():
     parser = get_parser()
     args = parser.parse_args()
 
+    if args.debug is not None:
+        Debug.configure(args.debug)
+
     deps_ts = None
     if args.depfile is not None and os.path.isfile(args.depfile):
         deps_ts = os.path.getmtime(args.depfile)
 
+    # Sources skipped as unchanged keep their previous depfile entries
+    prev_dep_m = read_depfile(args.depfile) if deps_ts is not None else {}
+    dep_m = {}
+
     fragment_m = {}
+    # Fragment name to the source it came from
+    src_m = {}
     for file in args.files:
-        print("Process %s" % file)
         if deps_ts is not None:
             file_ts = os.path.getmtime(file)
             if file_ts <= deps_ts:
-                print("Skip due to deps")
+                if file in prev_dep_m.keys():
+                    dep_m[file] = prev_dep_m[file]
                 continue
 
         fragments = ExtractCppEmbeddedDSL(file).extract()
-        print("fragments: %s" % str(fragments))
+        if len(fragments) > 0:
+            print("Process %s: %d fragments" % (file, len(fragments)))
 
         for f in fragments:
             if f.name in fragment_m.keys():
                 raise Exception("Duplicate fragment-name %s" % f.name)
             fragment_m[f.name] = f
+            src_m[f.name] = file
 
     if not os.path.isdir(args.outdir):
         os.makedirs(args.outdir, exist_ok=True)
 
-    for fn in fragment_m.keys():
-        Ctor.init(Context())
-
-        print("--> Process Fragment %s" % fn)
-        _globals = globals().copy()
-        exec(fragment_m[fn].content, _globals)
-        print("<-- Process Fragment %s" % fn)
-
-        Ctor.inst().elab()
-
-        header_path = os.path.join(args.outdir, "%s.h" % fn)
-        root_comp = Ctor.inst().ctxt().findDataTypeComponent(fragment_m[fn].root_comp)
-        if root_comp is None:
-            raise Exception("Failed to find root component %s" % fragment_m[fn].root_comp)
-        root_action = Ctor.inst().ctxt().findDataTypeAction(fragment_m[fn].root_action)
-        if root_action is None:
-            raise Exception("Failed to find root action %s" % fragment_m[fn].root_action)
-        gen = ZspDataModelCppGen()
-        gen._ctxt = "m_ctxt"
-        with open(header_path, "w") as fp:
-            fp.write(gen.generate(
-                root_comp, 
-                root_action, 
-                Ctor.inst().ctxt().getDataTypeFunctions()))
+    version = get_version()
+    gen_opts = get_gen_opts(args)
+    cache = {} if args.no_cache else load_cache(args.outdir)
+
+    # Only fragments whose content hash changed (or whose outputs are
+    # missing) need to be re-elaborated. The cache records the outputs,
+    # since the number of split parts is only known after generation
+    work_l = []
+    hash_m = {}
+    for fn,f in fragment_m.items():
+        hash_m[fn] = fragment_hash(f, version, gen_opts)
+        entry = cache.get(fn)
+        if (isinstance(entry, dict) and entry.get("hash") == hash_m[fn] and
+                all(map(lambda o: os.path.isfile(os.path.join(args.outdir, o)), entry["outputs"]))):
+            print("Fragment %s is up-to-date" % fn)
+            continue
+        work_l.append(f)
+
+    if args.jobs == 1 or len(work_l) <= 1:
+        # A single fragment can still spread its parts across processes
+        jobs = args.jobs if args.jobs > 0 else os.cpu_count()
+        results = map(lambda f: (f.name, gen_fragment(f, args.outdir, gen_opts, None, jobs)), work_l)
+        pool = None
+    else:
+        # Each fragment is elaborated in a fresh process, since type
+        # registration is process-global
+        pool = multiprocessing.Pool(
+            processes=(args.jobs if args.jobs > 0 else None),
+            maxtasksperchild=1)
+        results = zip(
+            map(lambda f: f.name, work_l),
+            pool.imap(gen_fragment_w, map(lambda f: (f, args.outdir, gen_opts, args.debug), work_l)))
+
+    try:
+        for fn,(changed,outputs) in results:
+            if not changed:
+                print("Header for %s is unchanged" % fn)
+            cache[fn] = {"hash" : hash_m[fn], "outputs" : outputs}
+    except Exception:
+        if pool is not None:
+            pool.terminate()
+            pool = None
+        raise
+    finally:
+        if pool is not None:
+            pool.close()
+            pool.join()
+        # Record fragments that completed, even if a later one failed
+        save_cache(args.outdir, cache)
 
     if args.depfile is not None:
-        with open(args.depfile, "w") as fp:
-            fp.write("\n")
+        for fn,src in src_m.items():
+            dep_m.setdefault(src, []).extend(map(
+                lambda o: os.path.join(args.outdir, o),
+                cache[fn]["outputs"]))
+        write_depfile(args.depfile, dep_m)
 
 if __name__ == "__main__":
     main()
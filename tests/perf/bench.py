@@ -0,0 +1,239 @@
+#****************************************************************************
+#* bench.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import argparse
+import asyncio
+import gc
+import importlib
+import json
+import platform
+import sys
+import time
+import tracemalloc
+from .model_gen import ModelGen
+
+# Benchmark parameters per scale. 'small' is quick enough to run on
+# every change; 'large' is closer to production-sized models
+SCALES = {
+    "small" : {
+        "components" : dict(n_comp=4, n_action=8),
+        "reg_hierarchy" : dict(depth=3, width=4, n_regs=16),
+        "parallel" : dict(width=16),
+        "replicate" : dict(count=100)
+    },
+    "medium" : {
+        "components" : dict(n_comp=16, n_action=16),
+        "reg_hierarchy" : dict(depth=4, width=4, n_regs=32),
+        "parallel" : dict(width=64),
+        "replicate" : dict(count=1000)
+    },
+    "large" : {
+        "components" : dict(n_comp=64, n_action=32),
+        "reg_hierarchy" : dict(depth=5, width=4, n_regs=64),
+        "parallel" : dict(width=256),
+        "replicate" : dict(count=10000)
+    }
+}
+
+# Metrics where an increase is a regression. Others (eg actions/sec)
+# regress when they decrease
+LOWER_IS_BETTER = ("decorate_s", "elab_s", "gen_s", "gen_bytes", "eval_s", "peak_mem_bytes")
+
+class Bench(object):
+
+    def __init__(self, ctxt_f, repeat=3, do_eval=True):
+        self.ctxt_f = ctxt_f
+        self.repeat = repeat
+        self.do_eval = do_eval
+
+    def _init(self):
+        import zsp_dataclasses.impl as impl
+        import vsc_dataclasses.impl as vsc_impl
+        ctxt = self.ctxt_f()
+        impl.Ctor.init(ctxt)
+        vsc_impl.Ctor.init(ctxt)
+        return impl.Ctor.inst()
+
+    def run(self, name, params):
+        """Runs benchmark 'name' 'repeat' times, reporting the minimum
+        of each time. Memory is measured by a separate run, since tracing
+        allocations slows everything else down"""
+        src, comp_n, action_n = getattr(ModelGen, name)(**params)
+        ret = None
+        for _ in range(self.repeat):
+            r = self._runOnce(name, src, comp_n, action_n, False)
+            if ret is None:
+                ret = r
+            else:
+                for k,v in r.items():
+                    if k.endswith("_s") and v is not None:
+                        ret[k] = min(ret[k], v)
+        ret["peak_mem_bytes"] = self._runOnce(
+            name, src, comp_n, action_n, True)["peak_mem_bytes"]
+        if ret["eval_s"] is not None and ret["eval_s"] > 0:
+            ret["actions_per_s"] = ret["n_actions"] / ret["eval_s"]
+        ret["name"] = name
+        ret["params"] = params
+        return ret
+
+    def _runOnce(self, name, src, comp_n, action_n, trace):
+        from zsp_dataclasses.impl.generators.zsp_data_model_cpp_gen import ZspDataModelCppGen
+        from zsp_dataclasses.profiling import EvalProfiler
+        gc.collect()
+        ctor = self._init()
+        ret = {}
+
+        if trace:
+            tracemalloc.start()
+        t = time.perf_counter()
+        ns = ModelGen.load(src, name)
+        ret["decorate_s"] = time.perf_counter() - t
+
+        t = time.perf_counter()
+        ctor.elab()
+        ret["elab_s"] = time.perf_counter() - t
+
+        comp_t = ctor.ctxt().findDataTypeComponent(comp_n)
+        action_t = ctor.ctxt().findDataTypeAction(action_n)
+        if comp_t is None or action_t is None:
+            raise Exception("Model %s does not declare %s and %s" % (name, comp_n, action_n))
+
+        t = time.perf_counter()
+        cpp = ZspDataModelCppGen().generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions())
+        ret["gen_s"] = time.perf_counter() - t
+        ret["gen_bytes"] = len(cpp)
+        del cpp
+
+        ret["eval_s"] = None
+        ret["n_actions"] = None
+        if self.do_eval:
+            root_t = ns[comp_n]
+            entry_t = getattr(root_t, action_n.split(".")[-1])
+            try:
+                root = root_t()
+                prof = EvalProfiler()
+                root.addEvalListener(prof)
+                t = time.perf_counter()
+                asyncio.run(root.eval(entry_t))
+                ret["eval_s"] = time.perf_counter() - t
+                ret["n_actions"] = sum(s.count for s in prof.action_m.values())
+            except NotImplementedError:
+                # The context has no model evaluator (eg the Python context)
+                pass
+
+        if trace:
+            ret["peak_mem_bytes"] = tracemalloc.get_traced_memory()[1]
+            tracemalloc.stop()
+        return ret
+
+def compare(results, baseline, tolerance):
+    """Returns a list of regressions of 'results' relative to 'baseline',
+    where a metric is worse by more than 'tolerance' (a fraction)"""
+    base_m = {}
+    for r in baseline["results"]:
+        base_m[(r["name"], json.dumps(r["params"], sort_keys=True))] = r
+
+    ret = []
+    for r in results["results"]:
+        b = base_m.get((r["name"], json.dumps(r["params"], sort_keys=True)), None)
+        if b is None:
+            continue
+        for k,v in r.items():
+            bv = b.get(k, None)
+            if not isinstance(v, (int, float)) or not isinstance(bv, (int, float)) or bv == 0:
+                continue
+            if k in LOWER_IS_BETTER:
+                delta = (v - bv) / bv
+            elif k == "actions_per_s":
+                delta = (bv - v) / bv
+            else:
+                continue
+            if delta > tolerance:
+                ret.append("%s.%s: %g -> %g (%+.1f%%)" % (
+                    r["name"], k, bv, v, 100 * delta))
+    return ret
+
+def mkCtxtFactory(spec):
+    """Returns the context factory named by 'module:callable'"""
+    if spec is None:
+        from zsp_dataclasses.impl.pyctxt.context import Context
+        return Context
+    mod_n, _, fn_n = spec.partition(":")
+    if fn_n == "":
+        raise Exception("Context factory %s must be of the form module:callable" % spec)
+    return getattr(importlib.import_module(mod_n), fn_n)
+
+def main(argv=None):
+    parser = argparse.ArgumentParser(
+        description="Measures elaboration, code generation, and evaluation of synthetic models")
+    parser.add_argument("--scale", choices=SCALES.keys(), default="small")
+    parser.add_argument("--bench", action="append", 
+        help="Benchmark to run (default: all). May be repeated")
+    parser.add_argument("--repeat", type=int, default=3)
+    parser.add_argument("--ctxt", 
+        help="Context factory (module:callable). Evaluation requires a native context")
+    parser.add_argument("--no-eval", action="store_true")
+    parser.add_argument("-o", "--out", help="Writes JSON results to this file")
+    parser.add_argument("--baseline", help="JSON results to compare against")
+    parser.add_argument("--tolerance", type=float, default=0.10,
+        help="Fractional regression that fails the comparison (default: 0.10)")
+    args = parser.parse_args(argv)
+
+    bench = Bench(mkCtxtFactory(args.ctxt), args.repeat, not args.no_eval)
+    sys.setrecursionlimit(max(sys.getrecursionlimit(), 10000))
+
+    names = args.bench if args.bench is not None else list(SCALES[args.scale].keys())
+    results = {
+        "version" : 1,
+        "scale" : args.scale,
+        "python" : platform.python_version(),
+        "machine" : platform.machine(),
+        "results" : []
+    }
+    for name in names:
+        if name not in SCALES[args.scale].keys():
+            raise Exception("Unknown benchmark %s" % name)
+        r = bench.run(name, SCALES[args.scale][name])
+        results["results"].append(r)
+        print("%-14s elab %.4fs gen %.4fs (%d bytes) eval %s peak %.1fMiB" % (
+            name, r["elab_s"], r["gen_s"], r["gen_bytes"],
+            ("%.4fs" % r["eval_s"]) if r["eval_s"] is not None else "n/a",
+            r["peak_mem_bytes"] / (1024*1024)))
+
+    if args.out is not None:
+        with open(args.out, "w") as fp:
+            json.dump(results, fp, indent=2, sort_keys=True)
+
+    if args.baseline is not None:
+        with open(args.baseline, "r") as fp:
+            baseline = json.load(fp)
+        regressions = compare(results, baseline, args.tolerance)
+        for r in regressions:
+            print("Regression: %s" % r)
+        if len(regressions) > 0:
+            return 1
+    return 0
+
+if __name__ == "__main__":
+    sys.exit(main())
@@ -0,0 +1,203 @@
+#****************************************************************************
+#* model_gen.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+
+class ModelGen(object):
+    """Generates the source of synthetic models. Each generator returns
+    (source, root component name, root action name). Models are written
+    as source, rather than built with type(), such that they declare
+    types exactly as user models do"""
+
+    def __init__(self):
+        self._lines = []
+        self._ind = ""
+
+    def println(self, s=""):
+        self._lines.append((self._ind + s) if s != "" else "")
+
+    def inc_indent(self):
+        self._ind += "    "
+
+    def dec_indent(self):
+        self._ind = self._ind[4:]
+
+    def getvalue(self):
+        return "\n".join(self._lines) + "\n"
+
+    def _action(self, name, n_rand):
+        self.println("@zdc.action")
+        self.println("class %s(object):" % name)
+        self.inc_indent()
+        for i in range(n_rand):
+            self.println("f%d : zdc.rand_uint16_t" % i)
+        if n_rand > 0:
+            self.println("")
+            self.println("@zdc.constraint")
+            self.println("def ab_c(self):")
+            self.inc_indent()
+            for i in range(n_rand):
+                self.println("self.f%d < %d" % (i, 100 * (i + 1)))
+            self.dec_indent()
+        else:
+            self.println("pass")
+        self.dec_indent()
+        self.println("")
+
+    @staticmethod
+    def components(n_comp, n_action, n_rand=2):
+        """A root component with 'n_comp' subcomponents, each with 
+        'n_action' actions. The root action traverses all actions"""
+        g = ModelGen()
+        for c in range(n_comp):
+            g.println("@zdc.component")
+            g.println("class sub%d_c(object):" % c)
+            g.inc_indent()
+            for a in range(n_action):
+                g._action("A%d" % a, n_rand)
+            g.dec_indent()
+            g.println("")
+
+        g.println("@zdc.component")
+        g.println("class pss_top(object):")
+        g.inc_indent()
+        for c in range(n_comp):
+            g.println("sub%d : sub%d_c" % (c, c))
+        g.println("")
+        g.println("@zdc.action")
+        g.println("class Entry(object):")
+        g.inc_indent()
+        g.println("@zdc.activity")
+        g.println("def activity(self):")
+        g.inc_indent()
+        for c in range(n_comp):
+            for a in range(n_action):
+                g.println("zdc.do[sub%d_c.A%d]" % (c, a))
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        return (g.getvalue(), "pss_top", "pss_top.Entry")
+
+    @staticmethod
+    def reg_hierarchy(depth, width, n_regs):
+        """Register groups nested 'depth' levels, with 'width' subgroups
+        per level and 'n_regs' registers per leaf group. The root action
+        accesses the first register of the first leaf group"""
+        g = ModelGen()
+        g.println("@zdc.struct")
+        g.println("class reg_t(object):")
+        g.inc_indent()
+        for i in range(4):
+            g.println("f%d : zdc.uint8_t" % i)
+        g.dec_indent()
+        g.println("")
+
+        leaf_sz = 4 * n_regs
+        g.println("@zdc.reg_group_c")
+        g.println("class group%d_t(object):" % depth)
+        g.inc_indent()
+        for r in range(n_regs):
+            g.println("r%d : zdc.reg_c[reg_t] = dict(offset=0x%x)" % (r, 4*r))
+        g.dec_indent()
+        g.println("")
+
+        sz = leaf_sz
+        for d in range(depth-1, -1, -1):
+            g.println("@zdc.reg_group_c")
+            g.println("class group%d_t(object):" % d)
+            g.inc_indent()
+            for w in range(width):
+                g.println("rg%d : group%d_t = dict(offset=0x%x)" % (w, d+1, w*sz))
+            g.dec_indent()
+            g.println("")
+            sz *= width
+
+        g.println("@zdc.component")
+        g.println("class pss_top(object):")
+        g.inc_indent()
+        g.println("regs : group0_t")
+        g.println("")
+        g.println("@zdc.action")
+        g.println("class Entry(object):")
+        g.inc_indent()
+        g.println("@zdc.exec.body")
+        g.println("def body(self):")
+        g.inc_indent()
+        g.println("self.comp.regs.%sr0.write_val(1)" % ("rg0." * depth))
+        g.println("self.comp.regs.%sr0.read_val()" % ("rg0." * depth))
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        return (g.getvalue(), "pss_top", "pss_top.Entry")
+
+    @staticmethod
+    def parallel(width, n_rand=2):
+        """A root action with a 'width'-branch parallel block"""
+        g = ModelGen()
+        g.println("@zdc.component")
+        g.println("class pss_top(object):")
+        g.inc_indent()
+        g._action("A", n_rand)
+        g.println("@zdc.action")
+        g.println("class Entry(object):")
+        g.inc_indent()
+        g.println("@zdc.activity")
+        g.println("def activity(self):")
+        g.inc_indent()
+        g.println("with zdc.parallel():")
+        g.inc_indent()
+        for i in range(width):
+            g.println("zdc.do[pss_top.A]")
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        return (g.getvalue(), "pss_top", "pss_top.Entry")
+
+    @staticmethod
+    def replicate(count, n_rand=2):
+        """A root action that replicates a traversal 'count' times"""
+        g = ModelGen()
+        g.println("@zdc.component")
+        g.println("class pss_top(object):")
+        g.inc_indent()
+        g._action("A", n_rand)
+        g.println("@zdc.action")
+        g.println("class Entry(object):")
+        g.inc_indent()
+        g.println("@zdc.activity")
+        g.println("def activity(self):")
+        g.inc_indent()
+        g.println("with zdc.replicate(%d):" % count)
+        g.inc_indent()
+        g.println("zdc.do[pss_top.A]")
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        g.dec_indent()
+        return (g.getvalue(), "pss_top", "pss_top.Entry")
+
+    @staticmethod
+    def load(src, name):
+        """Executes model source 'src', returning its namespace"""
+        import zsp_dataclasses as zdc
+        ns = {"zdc" : zdc, "__name__" : name}
+        exec(compile(src, "<%s>" % name, "exec"), ns)
+        return ns
@@ -0,0 +1,82 @@
+#****************************************************************************
+#* test_action.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import zsp_dataclasses as zdc
+from .test_base import EvaluatorStub, TestBase
+
+class TestAction(TestBase):
+
+    def test_action_facade_rebind(self):
+        from zsp_dataclasses.impl.typeinfo_action import TypeInfoAction
+
+        class Lib(object):
+            def __init__(self, name):
+                self.name = name
+            def getField(self, idx):
+                return Lib("%s.%d" % (self.name, idx))
+
+        class MI(object):
+            def __init__(self, obj, parent, idx):
+                self.obj = obj
+                self._parent = parent
+                self._idx = idx
+                self.libobj = None
+
+        class Facade(object):
+            pass
+
+        top = Facade()
+        top._modelinfo = MI(top, None, -1)
+        sub = Facade()
+        sub._modelinfo = MI(sub, top._modelinfo, 1)
+        top.f1 = sub
+        top.val = 5
+
+        TypeInfoAction.rebind(top._modelinfo, Lib("a2"))
+        self.assertEqual(top._modelinfo.libobj.name, "a2")
+        self.assertEqual(sub._modelinfo.libobj.name, "a2.1")
+
+    def test_reuse_actions_eval(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        seen = []
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Entry(object):
+                a : zdc.rand_uint8_t
+
+                @zdc.exec.body
+                def body(self):
+                    seen.append((id(self), int(self.a)))
+
+        ctor = Ctor.inst()
+        ctor.elab()
+        EvaluatorStub(pss_top.Entry, [{"a" : 1}, {"a" : 2}, {"a" : 3}]).install()
+        ctor.reuse_actions = True
+        top = pss_top()
+        asyncio.run(top.eval(pss_top.Entry, batch_sz=1))
+
+        # One facade backs every traversal, and sees its field values
+        self.assertEqual([v for _,v in seen], [1, 2, 3])
+        self.assertEqual(len(set(i for i,_ in seen)), 1)
@@ -0,0 +1,212 @@
+#****************************************************************************
+#* test_backends.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import threading
+import zsp_dataclasses as zdc
+from .test_base import TestBase
+
+class TestBackends(TestBase):
+
+    def _runBranches(self, backend, n):
+        order = []
+
+        async def branch(i):
+            order.append(i)
+            return i
+
+        async def run():
+            task_l = []
+            for i in range(n):
+                task_l.append(backend.fork(branch(i)))
+            ret = []
+            for t in task_l:
+                ret.append(await backend.join(t))
+            return ret
+
+        ret = asyncio.run(run())
+        backend.close()
+        self.assertEqual(ret, list(range(n)))
+        self.assertEqual(sorted(order), list(range(n)))
+
+    def test_asyncio(self):
+        self._runBranches(zdc.BackendAsyncio(), 16)
+
+    def test_threadpool(self):
+        self._runBranches(zdc.BackendThreadPool(max_workers=4), 16)
+
+    def test_threadpool_nested_fork(self):
+        backend = zdc.BackendThreadPool(max_workers=1)
+        main_t = threading.current_thread()
+
+        async def leaf():
+            return threading.current_thread()
+
+        async def branch():
+            # A nested fork must not wait on the (single-worker) pool
+            return await backend.join(backend.fork(leaf()))
+
+        async def run():
+            return await backend.join(backend.fork(branch()))
+
+        t = asyncio.run(run())
+        backend.close()
+        self.assertIsNot(t, main_t)
+
+    def test_threadpool_ctor_bind(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.pyctxt.context import Context
+        backend = zdc.BackendThreadPool(max_workers=2)
+        ctor = Ctor.mk(Context())
+
+        async def branch():
+            return (Ctor.inst(), threading.current_thread())
+
+        async def run():
+            with Ctor.bind(ctor):
+                task_l = [backend.fork(branch()) for _ in range(4)]
+                ret = [await backend.join(t) for t in task_l]
+                ret.append((await backend.offload(Ctor.inst), None))
+                return ret
+
+        ret = asyncio.run(run())
+        backend.close()
+        for inst,t in ret:
+            self.assertIs(inst, ctor)
+            self.assertIsNot(t, threading.current_thread())
+
+    def test_work_stealing(self):
+        backend = zdc.BackendWorkStealing(max_workers=4)
+        self._runBranches(backend, 16)
+        # Timing is only recorded on request
+        self.assertEqual(len(backend.timing), 0)
+
+    def test_work_stealing_nested(self):
+        backend = zdc.BackendWorkStealing(max_workers=2, max_active=2, record_timing=True)
+
+        async def node(d):
+            if d == 0:
+                await asyncio.sleep(0)
+                return 1
+            task_l = [backend.fork(node(d-1)) for _ in range(4)]
+            await backend.join_all(task_l)
+            ret = 0
+            for t in task_l:
+                ret += await backend.join(t)
+            return ret
+
+        ret = asyncio.run(node(3))
+        backend.close()
+        self.assertEqual(ret, 64)
+        # One timing record for each of the 4+16+64 branches
+        self.assertEqual(len(backend.timing), 84)
+        for t in backend.timing:
+            self.assertGreaterEqual(t.elapsed, 0)
+
+    def test_join_all_exception(self):
+        backend = zdc.BackendAsyncio()
+
+        async def slow():
+            await asyncio.sleep(10)
+
+        async def fail():
+            raise Exception("branch failed")
+
+        async def run():
+            task_l = [backend.fork(slow()), backend.fork(fail())]
+            # The failure is seen without waiting on the first branch
+            with self.assertRaises(Exception):
+                await backend.join_all(task_l)
+            await asyncio.gather(task_l[0], return_exceptions=True)
+            return task_l[0].cancelled()
+
+        self.assertTrue(asyncio.run(run()))
+
+    def test_batched(self):
+        backend = zdc.BackendBatched(batch_sz=4)
+        self._runBranches(backend, 10)
+        self.assertEqual(backend.n_batches, 3)
+
+    def test_batched_exception(self):
+        backend = zdc.BackendBatched(batch_sz=4)
+
+        async def ok():
+            return 1
+
+        async def fail():
+            raise Exception("branch failed")
+
+        async def run():
+            t1 = backend.fork(fail())
+            t2 = backend.fork(ok())
+            with self.assertRaises(Exception):
+                await backend.join(t1)
+            return await backend.join(t2)
+
+        self.assertEqual(asyncio.run(run()), 1)
+
+    def test_batched_holds_tasks(self):
+        backend = zdc.BackendBatched(batch_sz=2)
+
+        async def run():
+            t_l = [backend.fork(asyncio.sleep(0, result=i)) for i in range(4)]
+            n_held = len(backend._task_s)
+            ret = [await backend.join(t) for t in t_l]
+            await asyncio.sleep(0)
+            return n_held, ret
+
+        n_held, ret = asyncio.run(run())
+        self.assertEqual(n_held, 2)
+        self.assertEqual(ret, [0, 1, 2, 3])
+        self.assertEqual(len(backend._task_s), 0)
+
+    def test_offload_default(self):
+        async def run():
+            return await zdc.offload(lambda a, b: a+b, 1, 2)
+        self.assertEqual(asyncio.run(run()), 3)
+
+    def test_rt_ctxt_isolation(self):
+        from zsp_dataclasses.impl.rt_ctxt import RtCtxt
+
+        async def scenario(g):
+            with RtCtxt.bind():
+                RtCtxt.inst().push_exec_group(g)
+                await asyncio.sleep(0)
+                ret = RtCtxt.inst().exec_group()
+                RtCtxt.inst().pop_exec_group()
+                return ret
+
+        async def run():
+            return await asyncio.gather(*(scenario(i) for i in range(4)))
+
+        outer = RtCtxt.inst()
+        self.assertEqual(asyncio.run(run()), list(range(4)))
+        self.assertIs(RtCtxt.inst(), outer)
+
+    def test_ctor_bind(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.pyctxt.context import Context
+
+        default = Ctor.inst()
+        ctor = Ctor.mk(Context())
+        with Ctor.bind(ctor):
+            self.assertIs(Ctor.inst(), ctor)
+        self.assertIs(Ctor.inst(), default)
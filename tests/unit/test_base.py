@@ -2,9 +2,57 @@
 import zsp_dataclasses.impl as impl
 import vsc_dataclasses.impl as vsc_impl
 from unittest import TestCase
+from zsp_dataclasses.impl.context import ModelEvalNodeT
 from zsp_dataclasses.impl.pyctxt.context import Context
 
 
+class EvaluatorStub(object):
+    """Stands in for the native model evaluator, which the Python context
+    lacks. Each evaluation traverses 'action_t' once per entry of 'vals_l'
+    (a field-name to value map). Like the native evaluator, each traversal
+    gets a new model object, and its facade comes from the create hook"""
+
+    class Iterator(object):
+        def __init__(self, stub, root):
+            self.stub = stub
+            self.root = root
+            self.i = 0
+            self.field = None
+
+        def next(self):
+            stub = self.stub
+            if self.i >= len(stub.vals_l):
+                return False
+            self.field = stub.action_ti.lib_typeobj.mkRootField(stub.ctxt_b, "action", False)
+            self.field.getField(0).setRef(self.root)
+            for name,v in stub.vals_l[self.i].items():
+                self.field.getField(stub.idx_m[name]).val().set_val_i(v)
+            stub.action_ti.createHook(self.field)
+            self.i += 1
+            return True
+
+        def type(self):
+            return ModelEvalNodeT.Action
+
+        def action(self):
+            return self.field
+
+    def __init__(self, action_t, vals_l):
+        from zsp_dataclasses.impl.typeinfo_action import TypeInfoAction
+        self.action_ti = TypeInfoAction.get(action_t._typeinfo)
+        self.idx_m = {}
+        for i,f in enumerate(self.action_ti.lib_typeobj.getFields()):
+            self.idx_m[f.name()] = i
+        self.vals_l = vals_l
+        self.ctxt_b = vsc_impl.Ctor.inst().ctxt().mkModelBuildContext(impl.Ctor.inst().ctxt())
+
+    def install(self):
+        impl.Ctor.inst().ctxt().mkModelEvaluator = lambda: self
+
+    def eval(self, randstate, root, action_t):
+        return EvaluatorStub.Iterator(self, root)
+
+
 class TestBase(TestCase):
 
     def setUp(self) -> None:
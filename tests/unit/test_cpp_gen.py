@@ -20,6 +20,7 @@
 #*
 #****************************************************************************
 import zsp_dataclasses as zdc
+from zsp_dataclasses.impl.generators.collect_type_deps import CollectTypeDeps
 from zsp_dataclasses.impl.generators.zsp_data_model_cpp_gen import ZspDataModelCppGen
 from .test_base import TestBase
 
@@ -116,6 +117,17 @@ class TestCppGen(TestBase):
             ctor.ctxt().getDataTypeFunctions())
         print("Cpp:\n%s\n" % cpp)
 
+        # Functions and types are referenced through handle tables
+        self.assertNotIn("findDataTypeFunction(", cpp)
+        self.assertNotIn("findDataTypeComponent(", cpp)
+        self.assertIn("pss_top_functions[", cpp)
+        self.assertIn("pss_top_comp_types[0] = pss_top_t;", cpp)
+
+        # Tables are private to the including file, and named for the
+        # model, such that several models can be included together
+        self.assertIn("static zsp::arl::dm::IDataTypeComponent *pss_top_comp_types[", cpp)
+        self.assertNotIn(" *comp_types[", cpp)
+
     def test_single_layer_reg_group(self):
         ctor = zdc.impl.Ctor.inst()
 
@@ -159,6 +171,100 @@ class TestCppGen(TestBase):
             ])
         print("Cpp:\n%s\n" % cpp)
 
+    def test_reg_bulk_ops(self):
+        ctor = zdc.impl.Ctor.inst()
+
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint8_t
+            f2 : zdc.uint8_t
+            f3 : zdc.uint8_t
+            f4 : zdc.uint8_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x10)
+            r2 : zdc.reg_c[my_reg1] = dict(offset=0x14)
+            r3 : zdc.reg_c[my_reg1] = dict(offset=0x18)
+            r4 : zdc.reg_c[my_reg1] = dict(offset=0x1c)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+                d1 : zdc.uint32_t
+                d2 : zdc.uint32_t
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.r1.write_block([1, 2, 3, 4])
+                    self.comp.regs.r2.modify(f1=1, f3=2)
+                    self.comp.regs.r3.read_block([self.d1, self.d2])
+
+        ctor.elab()
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+
+        cpp = ZspDataModelCppGen().generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions(),
+            [
+                ctor.ctxt().findDataTypeComponent(my_regs.__qualname__)
+            ])
+        self.assertIn("pss::core::reg_write_block", cpp)
+        self.assertIn("pss::core::reg_modify", cpp)
+        self.assertIn("pss::core::reg_read_block", cpp)
+
+    def test_reg_array(self):
+        ctor = zdc.impl.Ctor.inst()
+
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint16_t
+            f2 : zdc.uint16_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x0)
+            rf : zdc.reg_c[my_reg1] = dict(offset=0x100, count=1024, stride=4)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.rf[3].write_val(1)
+                    self.comp.regs.rf[-1].read()
+
+        ctor.elab()
+
+        regs_t = ctor.ctxt().findDataTypeComponent(my_regs.__qualname__)
+        rf_l = list(filter(lambda f: f.name() == "rf", regs_t.getFields()))
+        self.assertEqual(len(rf_l), 1)
+        self.assertEqual(rf_l[0].getCount(), 1024)
+        self.assertEqual(rf_l[0].getStride(), 4)
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+
+        cpp = ZspDataModelCppGen(reg_tables=True).generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions(),
+            [regs_t])
+        self.assertIn("rf_f->setCount(1024);", cpp)
+        self.assertIn("rf_f->setStride(4);", cpp)
+        # Element accesses index the array rather than extending its path
+        self.assertIn("mkTypeExprArrIndex(", cpp)
+
     def test_proc_stmt_if(self):
         ctor = zdc.impl.Ctor.inst()
 
@@ -269,6 +375,162 @@ class TestCppGen(TestBase):
             ctor.ctxt().getDataTypeFunctions())
         print("Cpp:\n%s\n" % cpp)
 
+    def test_streaming_sink(self):
+        ctor = zdc.impl.Ctor.inst()
+
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint8_t
+            f2 : zdc.uint8_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x10)
+            r2 : zdc.reg_c[my_reg1] = dict(offset=0x14)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.r1.read()
+
+        ctor.elab()
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+        extra_types = [ctor.ctxt().findDataTypeComponent(my_regs.__qualname__)]
+
+        cpp = ZspDataModelCppGen().generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions(),
+            extra_types)
+
+        class Sink(object):
+            def __init__(self):
+                self.chunks = []
+            def write(self, s):
+                self.chunks.append(s)
+
+        # Use a tiny chunk size to force many partial writes
+        sink = Sink()
+        ret = ZspDataModelCppGen(sink=sink, chunk_sz=16).generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions(),
+            extra_types)
+
+        self.assertIsNone(ret)
+        self.assertGreater(len(sink.chunks), 1)
+        self.assertEqual(cpp, "".join(sink.chunks))
+
+    def test_reg_group_tables(self):
+        ctor = zdc.impl.Ctor.inst()
+
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint8_t
+            f2 : zdc.uint8_t
+            f3 : zdc.uint16_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x10)
+            r2 : zdc.reg_c[my_reg1] = dict(offset=0x14)
+            r3 : zdc.reg_c[my_reg1] = dict(offset=0x18)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.r2.read()
+
+        ctor.elab()
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+
+        cpp = ZspDataModelCppGen(reg_tables=True).generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions(),
+            [
+                ctor.ctxt().findDataTypeComponent(my_regs.__qualname__)
+            ])
+        print("Cpp:\n%s\n" % cpp)
+
+        # One table entry per register, and a single builder loop
+        self.assertIn("{\"r1\", 16, 0},", cpp)
+        self.assertIn("{\"r3\", 24, 0},", cpp)
+        self.assertEqual(cpp.count("->mkTypeFieldReg("), 1)
+
+    def test_dedup_types(self):
+        ctor = zdc.impl.Ctor.inst()
+
+        @zdc.struct
+        class ctrl_a_t(object):
+            en : zdc.uint8_t
+            mode : zdc.uint8_t
+
+        @zdc.struct
+        class ctrl_b_t(object):
+            en : zdc.uint8_t
+            mode : zdc.uint8_t
+
+        @zdc.struct
+        class status_t(object):
+            en : zdc.uint8_t
+            mode : zdc.uint16_t
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Entry(object):
+                a : ctrl_a_t
+                b : ctrl_b_t
+                c : status_t
+
+        ctor.elab()
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+        ctrl_a = ctor.ctxt().findDataTypeStruct(ctrl_a_t.__qualname__)
+        ctrl_b = ctor.ctxt().findDataTypeStruct(ctrl_b_t.__qualname__)
+        status = ctor.ctxt().findDataTypeStruct(status_t.__qualname__)
+
+        collector = CollectTypeDeps(dedup=True)
+        types = collector.collect(comp_t, action_t)
+
+        # ctrl_b_t has the same layout as ctrl_a_t; status_t differs
+        self.assertEqual(len(list(filter(lambda t: t in (ctrl_a, ctrl_b), types))), 1)
+        self.assertIn(status, types)
+        self.assertEqual(len(collector.aliases()), 1)
+
+        cpp = ZspDataModelCppGen(dedup_types=True).generate(
+            comp_t,
+            action_t,
+            ctor.ctxt().getDataTypeFunctions())
+        print("Cpp:\n%s\n" % cpp)
+
+        shared, dup = (ctrl_a, ctrl_b) if ctrl_a in types else (ctrl_b, ctrl_a)
+
+        # One definition each for the shared type and status_t. Field 'b'
+        # refers to the shared type, so the duplicate is never named
+        self.assertEqual(cpp.count("mkDataTypeStruct("), 2)
+        self.assertNotIn("\"%s\"" % dup.name(), cpp)
+        self.assertIn("\"%s\"" % shared.name(), cpp)
+
 # Issue: Anonymous type, so pool binding rules are unclear
 # Resolution: with fully-specified binding, is a pool mandatory?
 # Resolution: Pool comes from the source and destination
@@ -288,4 +550,59 @@ class TestCppGen(TestBase):
 #
 
 
-        
\ No newline at end of file
+        
+    def test_split(self):
+        @zdc.import_fn
+        def my_fn(a : int):
+            pass
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class A(object):
+                a : zdc.rand_uint8_t
+
+            @zdc.action
+            class B(object):
+                b : zdc.rand_uint8_t
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    my_fn(1)
+
+        ctor = zdc.impl.Ctor.inst()
+        ctor.elab()
+
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        comp_t = ctor.ctxt().findDataTypeComponent(pss_top.__qualname__)
+
+        def gen(jobs):
+            gen = ZspDataModelCppGen()
+            gen._ctxt = "m_ctxt"
+            return gen.generateSplit(
+                "model",
+                comp_t,
+                action_t,
+                ctor.ctxt().getDataTypeFunctions(),
+                n_parts=2,
+                jobs=jobs)
+
+        out_l = gen(1)
+        self.assertEqual(out_l[0][0], "model.h")
+        self.assertEqual(len(out_l), 3)
+        index = out_l[0][1]
+        self.assertIn("static inline void model_build(", index)
+        self.assertLess(index.index("model_part0(m_ctxt"), index.index("model_part1(m_ctxt"))
+
+        parts = "".join(t for _,t in out_l[1:])
+        self.assertIn("void model_part1(zsp::arl::dm::IContext *m_ctxt, model_tables_t &tables) {", parts)
+        self.assertIn("comp_types[0] = pss_top_t;", parts)
+        self.assertNotIn("findDataTypeFunction(", parts)
+        self.assertIn("functions[0] = ", out_l[1][1])
+
+        # Forked workers produce the same parts
+        self.assertEqual(gen(2), out_l)
@@ -0,0 +1,47 @@
+#****************************************************************************
+#* test_debug.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import logging
+from zsp_dataclasses.impl.debug import Debug
+from .test_base import TestBase
+
+class TestDebug(TestBase):
+
+    def test_disabled_by_default(self):
+        dbg = Debug.get("test_disabled")
+        self.assertFalse(dbg.en)
+
+    def test_configure_levels(self):
+        dbg_a = Debug.get("test_a")
+        dbg_b = Debug.get("test_b")
+        Debug.configure("test_a,test_b=INFO")
+        try:
+            self.assertTrue(dbg_a.en)
+            self.assertFalse(dbg_b.en)
+            self.assertTrue(dbg_b.info_en)
+
+            with self.assertLogs("zsp_dataclasses.test_a", level=logging.DEBUG) as cm:
+                if dbg_a.en:
+                    dbg_a.debug("value=%d", 10)
+            self.assertEqual(cm.records[0].getMessage(), "value=10")
+        finally:
+            Debug.configure("test_a=WARNING,test_b=WARNING")
+        self.assertFalse(dbg_a.en)
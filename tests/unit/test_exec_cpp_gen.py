@@ -0,0 +1,284 @@
+#****************************************************************************
+#* test_exec_cpp_gen.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import shutil
+import tempfile
+import unittest
+import zsp_dataclasses as zdc
+from zsp_dataclasses.impl.exec_compiler import ExecApi, ExecCompiler
+from zsp_dataclasses.impl.exec_interp import ExecInterp
+from zsp_dataclasses.impl.generators.exec_cpp_gen import ExecCppGen
+from .test_base import TestBase
+
+class TestExecCppGen(TestBase):
+
+    def _mkModel(self):
+        @zdc.import_fn
+        def my_fn(a : int, b : int):
+            pass
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    my_fn(10, 12)
+
+        ctor = zdc.impl.Ctor.inst()
+        ctor.elab()
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        self.assertIsNotNone(action_t)
+        return action_t
+
+    def test_lower_exec(self):
+        action_t = self._mkModel()
+        gen = ExecCppGen()
+        src = gen.generate(
+            [action_t], 
+            zdc.impl.Ctor.inst().ctxt().getDataTypeFunctions())
+
+        self.assertEqual(len(gen.entries), 1)
+        self.assertEqual(gen.entries[0][0], "%s::body_0" % action_t.name())
+        self.assertEqual(len(gen.call_names), 1)
+        self.assertIn("api->call(api, self, 0", src)
+
+    @unittest.skipIf(shutil.which("c++") is None, "No C++ compiler available")
+    def test_compile_exec(self):
+        action_t = self._mkModel()
+        gen = ExecCppGen()
+        src = gen.generate([action_t])
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            lib = ExecCompiler(cache_dir=cache_dir).compile(src)
+
+            # A second compile of the same source hits the cache
+            self.assertIs(ExecCompiler(cache_dir=cache_dir).compile(src).path, lib.path)
+
+            calls = []
+            api = ExecApi.mk(
+                lambda kind, off, path: 0,
+                lambda kind, off, path, val: None,
+                lambda name, ref, args: calls.append((name, args)))
+            lib.call("%s::body_0" % action_t.name(), api)
+
+        self.assertEqual(len(calls), 1)
+        self.assertEqual(calls[0][1], (10, 12))
+
+    @unittest.skipIf(shutil.which("c++") is None, "No C++ compiler available")
+    def test_compile_signed_warnings(self):
+        @zdc.import_fn
+        def report(v : int):
+            pass
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Entry(object):
+                f1 : zdc.rand_int16_t
+
+                @zdc.exec.body
+                def body(self):
+                    with zdc.if_then(self.f1 < 10):
+                        report(1)
+                    with zdc.else_then:
+                        report(2)
+
+                @zdc.exec.post_solve
+                def post_solve(self):
+                    pass
+
+        ctor = zdc.impl.Ctor.inst()
+        ctor.elab()
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        src = ExecCppGen().generate([action_t])
+        self.assertIn("(int16_t)(api->read_field(", src)
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            lib = ExecCompiler(
+                cache_dir=cache_dir,
+                cxxflags=["-O2", "-fPIC", "-shared", "-std=c++11", "-Wall", "-Wextra", "-Werror"]).compile(src)
+
+            # 0xFFFF is -1 as a 16-bit signed value
+            calls = []
+            api = ExecApi.mk(
+                lambda kind, off, path: 0xFFFF,
+                lambda kind, off, path, val: None,
+                lambda name, ref, args: calls.append(args))
+            lib.call("%s::body_0" % action_t.name(), api)
+            lib.call("%s::post_solve_0" % action_t.name(), api)
+
+        self.assertEqual(calls, [(1,)])
+
+    def _mkReadBlockModel(self):
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint16_t
+            f2 : zdc.uint16_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x10)
+            r2 : zdc.reg_c[my_reg1] = dict(offset=0x14)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+                a : zdc.uint32_t
+                b : zdc.uint32_t
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.r1.read_block([self.a, self.b])
+
+        ctor = zdc.impl.Ctor.inst()
+        ctor.elab()
+        action_t = ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+        name_l = [f.name() for f in action_t.getFields()]
+        return action_t, name_l.index("a"), name_l.index("b")
+
+    class Field(object):
+        """Model field holding a value and, on demand, sub-fields"""
+        def __init__(self):
+            self.v = 0
+            self.field_m = {}
+        def getField(self, idx):
+            if idx not in self.field_m.keys():
+                self.field_m[idx] = TestExecCppGen.Field()
+            return self.field_m[idx]
+        def val(self):
+            return self
+        def val_i(self):
+            return self.v
+        def set_val_i(self, v):
+            self.v = v
+
+    def test_interp_read_block(self):
+        action_t, a_idx, b_idx = self._mkReadBlockModel()
+        calls = []
+        def call(name, ctxt_f, args):
+            calls.append((name, args))
+            return [0x1234, 0x5678]
+        body_f = ExecInterp(call).build(action_t.getExecs()[0].getBody())
+
+        root = TestExecCppGen.Field()
+        body_f(root)
+        self.assertEqual(calls, [("pss::core::reg_read_block", [0, 0])])
+        self.assertEqual(root.getField(a_idx).v, 0x1234)
+        self.assertEqual(root.getField(b_idx).v, 0x5678)
+
+    @unittest.skipIf(shutil.which("c++") is None, "No C++ compiler available")
+    def test_compile_read_block(self):
+        action_t, a_idx, b_idx = self._mkReadBlockModel()
+        src = ExecCppGen().generate([action_t])
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            lib = ExecCompiler(cache_dir=cache_dir).compile(src)
+            write_m = {}
+            api = ExecApi.mk(
+                lambda kind, off, path: 0,
+                lambda kind, off, path, val: write_m.__setitem__(path, val),
+                lambda name, ref, args: (0x1234, 0x5678))
+            lib.call("%s::body_0" % action_t.name(), api)
+
+        self.assertEqual(write_m, {(a_idx,) : 0x1234, (b_idx,) : 0x5678})
+
+    def _mkRegArrayModel(self):
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint16_t
+            f2 : zdc.uint16_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            rf : zdc.reg_c[my_reg1] = dict(offset=0x100, count=8, stride=4)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.rf[3].write_val(1)
+                    self.comp.regs.rf[5].write_val(2)
+
+        ctor = zdc.impl.Ctor.inst()
+        ctor.elab()
+        return ctor.ctxt().findDataTypeAction(pss_top.Entry.__qualname__)
+
+    def test_interp_reg_array_elem(self):
+        action_t = self._mkRegArrayModel()
+        calls = []
+        def call(name, ctxt_f, args):
+            calls.append((ctxt_f, args))
+        body_f = ExecInterp(call).build(action_t.getExecs()[0].getBody())
+
+        root = TestExecCppGen.Field()
+        body_f(root)
+        self.assertEqual(len(calls), 2)
+        # Each element is passed as (array field, index)
+        (arr_3, idx_3), args_3 = calls[0]
+        (arr_5, idx_5), args_5 = calls[1]
+        self.assertIs(arr_3, arr_5)
+        self.assertEqual((idx_3, args_3), (3, [1]))
+        self.assertEqual((idx_5, args_5), (5, [2]))
+
+    @unittest.skipIf(shutil.which("c++") is None, "No C++ compiler available")
+    def test_compile_reg_array_elem(self):
+        action_t = self._mkRegArrayModel()
+        src = ExecCppGen().generate([action_t])
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            lib = ExecCompiler(cache_dir=cache_dir).compile(src)
+            calls = []
+            api = ExecApi.mk(
+                lambda kind, off, path: 0,
+                lambda kind, off, path, val: None,
+                lambda name, ref, args: calls.append((ref, list(args))))
+            lib.call("%s::body_0" % action_t.name(), api)
+
+        self.assertEqual(len(calls), 2)
+        # Both elements share the array reference, and carry the index
+        # separately rather than as an extra path element
+        self.assertEqual(len(calls[0][0]), 4)
+        self.assertEqual(calls[0][0][:3], calls[1][0][:3])
+        self.assertEqual((calls[0][0][3], calls[0][1]), (3, [1]))
+        self.assertEqual((calls[1][0][3], calls[1][1]), (5, [2]))
+
+    def test_interp_exec(self):
+        action_t = self._mkModel()
+        calls = []
+        interp = ExecInterp(lambda name, ctxt_f, args: calls.append((name, ctxt_f, args)))
+        body_f = interp.build(action_t.getExecs()[0].getBody())
+
+        body_f(None)
+        body_f(None)
+        self.assertEqual(len(calls), 2)
+        self.assertEqual(calls[0][1:], (None, [10, 12]))
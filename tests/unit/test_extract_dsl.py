@@ -0,0 +1,84 @@
+#****************************************************************************
+#* test_extract_dsl.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import io
+import os
+import tempfile
+from zsp_dataclasses.util.extract_cpp_embedded_dsl import ExtractCppEmbeddedDSL
+from .test_base import TestBase
+
+SRC = """#define ZSP_DATACLASSES(name, comp, action, content)
+
+TEST_F(TestSuite, smoke) {
+    ZSP_DATACLASSES(TestSuite_smoke, pss_top, pss_top.Entry, R"(
+        @zdc.component
+        class pss_top(object):
+            pass
+    )");
+    const char *s = "ZSP_DATACLASSES(";
+    ZSP_DATACLASSES(TestSuite_delim, pss_top, pss_top.Entry, R"zsp(
+        print(")(")
+    )zsp");
+}
+"""
+
+class TestExtractDSL(TestBase):
+
+    def setUp(self):
+        self._dir = tempfile.TemporaryDirectory()
+        return super().setUp()
+
+    def tearDown(self):
+        self._dir.cleanup()
+        return super().tearDown()
+
+    def _write(self, name, content):
+        path = os.path.join(self._dir.name, name)
+        with open(path, "w") as fp:
+            fp.write(content)
+        return path
+
+    def test_extract(self):
+        fragments = ExtractCppEmbeddedDSL(self._write("a.cpp", SRC)).extract()
+        self.assertEqual(
+            list(map(lambda f: f.name, fragments)),
+            ["TestSuite_smoke", "TestSuite_delim"])
+        self.assertEqual(fragments[0].root_comp, "pss_top")
+        self.assertEqual(fragments[0].root_action, "pss_top.Entry")
+        self.assertEqual(
+            fragments[0].content, 
+            "\n@zdc.component\nclass pss_top(object):\n    pass\n")
+        self.assertEqual(fragments[1].content, "\nprint(\")(\")\n")
+
+    def test_extract_stream(self):
+        fragments = ExtractCppEmbeddedDSL(io.StringIO(SRC), "a.cpp").extract()
+        self.assertEqual(len(fragments), 2)
+
+    def test_no_macro(self):
+        self.assertEqual(
+            ExtractCppEmbeddedDSL(self._write("b.cpp", "int main() { }\n")).extract(), [])
+        self.assertEqual(
+            ExtractCppEmbeddedDSL(self._write("c.cpp", "")).extract(), [])
+
+    def test_unbalanced(self):
+        path = self._write("d.cpp", "ZSP_DATACLASSES(a, b, c, R\"(\n  x\n)\"\n")
+        with self.assertRaises(Exception):
+            ExtractCppEmbeddedDSL(path).extract()
@@ -0,0 +1,157 @@
+#****************************************************************************
+#* test_farm.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import socket
+import threading
+import zsp_dataclasses as zdc
+from .test_base import EvaluatorStub, TestBase
+
+class FakeRoot(object):
+    """Stands in for an elaborated component. Runs 'seed % 4' actions,
+    and fails on negative seeds"""
+
+    def __init__(self):
+        self.listener_l = []
+        self.last = None
+
+    def addEvalListener(self, l):
+        self.listener_l.append(l)
+
+    async def eval(self, action_t, batch_sz=1, seed=None):
+        if seed < 0:
+            raise Exception("Bad seed %d" % seed)
+        for i in range(seed % 4):
+            for l in self.listener_l:
+                l.action(action_t(), 0.0, 0.0, 0.0)
+        self.last = (action_t.__qualname__, seed)
+
+class TestFarm(TestBase):
+
+    class A(object):
+        pass
+
+    class B(object):
+        pass
+
+    def _collect(self, root, action_t, seed):
+        return root.last
+
+    def _work(self, n):
+        return [(TestFarm.A if (i%2) == 0 else TestFarm.B, i) for i in range(n)]
+
+    def _check(self, res_l, n):
+        self.assertEqual(sorted(r.idx for r in res_l), list(range(n)))
+        for r in res_l:
+            self.assertTrue(r.ok)
+            action = (TestFarm.A if (r.idx%2) == 0 else TestFarm.B).__qualname__
+            self.assertEqual(r.action, action)
+            self.assertEqual(r.data, (action, r.idx))
+            self.assertEqual(r.n_actions, r.idx % 4)
+
+    def test_fork(self):
+        farm = zdc.FarmRunner(
+            FakeRoot(), 
+            [TestFarm.A, TestFarm.B], 
+            n_workers=3, 
+            collect=self._collect,
+            chunk_sz=4)
+        res_l = list(farm.run(self._work(50)))
+        self._check(res_l, 50)
+        self.assertGreater(len(set(r.worker for r in res_l)), 0)
+
+    def test_failure(self):
+        farm = zdc.FarmRunner(FakeRoot(), [TestFarm.A], n_workers=2)
+        res_l = sorted(farm.run([(TestFarm.A, 1), (TestFarm.A, -1)]), key=lambda r: r.idx)
+        self.assertTrue(res_l[0].ok)
+        self.assertFalse(res_l[1].ok)
+        self.assertIn("Bad seed -1", res_l[1].error)
+
+    def test_remote(self):
+        with socket.socket() as s:
+            s.bind(("localhost", 0))
+            port = s.getsockname()[1]
+        address = ("localhost", port)
+
+        worker = zdc.FarmWorker(FakeRoot(), [TestFarm.A, TestFarm.B], self._collect)
+        t = threading.Thread(target=worker.connect, args=(address, b"farm"))
+        t.start()
+
+        farm = zdc.FarmRunner(
+            FakeRoot(), 
+            [TestFarm.A, TestFarm.B], 
+            n_workers=0,
+            address=address,
+            authkey=b"farm")
+        res_l = list(farm.run(self._work(20)))
+        t.join()
+        self._check(res_l, 20)
+
+    def test_remote_requires_authkey(self):
+        with self.assertRaises(Exception):
+            zdc.FarmRunner(FakeRoot(), [TestFarm.A], n_workers=0, address=("localhost", 0))
+
+    def test_remote_no_workers(self):
+        farm = zdc.FarmRunner(
+            FakeRoot(), 
+            [TestFarm.A], 
+            n_workers=0,
+            address=("localhost", 0),
+            authkey=b"farm",
+            worker_timeout=0.2)
+        with self.assertRaises(Exception) as cm:
+            list(farm.run(self._work(4)))
+        self.assertIn("No farm workers", str(cm.exception))
+
+    def test_component(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        seen = []
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Entry(object):
+                a : zdc.rand_uint8_t
+
+                @zdc.exec.body
+                def body(self):
+                    seen.append(int(self.a))
+
+        def collect(root, action_t, seed):
+            ret = list(seen)
+            seen.clear()
+            return ret
+
+        Ctor.inst().elab()
+        EvaluatorStub(pss_top.Entry, [{"a" : 1}, {"a" : 2}, {"a" : 3}]).install()
+        farm = zdc.FarmRunner(
+            pss_top(), 
+            [pss_top.Entry], 
+            n_workers=2, 
+            collect=collect,
+            chunk_sz=2)
+        res_l = list(farm.run([(pss_top.Entry, s) for s in range(6)]))
+
+        self.assertEqual(sorted(r.idx for r in res_l), list(range(6)))
+        for r in res_l:
+            self.assertTrue(r.ok, r.error)
+            self.assertEqual(r.n_actions, 3)
+            self.assertEqual(r.data, [1, 2, 3])
@@ -19,6 +19,7 @@
 #*     Author: 
 #*
 #****************************************************************************
+import asyncio
 import zsp_dataclasses as zdc
 from .test_base import TestBase
 
@@ -60,4 +61,40 @@ class TestFunction(TestBase):
                     my_function(1, 2)
 
         from zsp_dataclasses.impl.ctor import Ctor
-        Ctor.inst().elab()
\ No newline at end of file
+        Ctor.inst().elab()
+
+    def test_function_handle(self):
+        @zdc.import_fn
+        def my_function(a : int, b : int):
+            pass
+
+        from zsp_dataclasses.impl.ctor import Ctor
+        ctor = Ctor.inst()
+        ctor.elab()
+        ctxt = ctor.ctxt()
+
+        h = ctxt.findDataTypeFunctionHandle(my_function.__qualname__)
+        self.assertGreaterEqual(h, 0)
+        self.assertIs(
+            ctxt.getDataTypeFunctionByHandle(h),
+            ctxt.findDataTypeFunction(my_function.__qualname__))
+        self.assertEqual(ctxt.findDataTypeFunctionHandle("no_such_fn"), -1)
+
+    def test_import_bind(self):
+        @zdc.import_fn
+        def xfer(addr : int, data : zdc.buf_t):
+            pass
+
+        @zdc.fn
+        def local(a : int):
+            pass
+
+        from zsp_dataclasses.impl.ctor import Ctor
+        Ctor.inst().elab()
+
+        call = xfer.bind(lambda addr, data: addr + len(data))
+        self.assertEqual(asyncio.run(xfer(1, bytearray(8))), 9)
+        self.assertEqual(call.n_calls, 1)
+
+        with self.assertRaises(Exception):
+            local.bind(lambda a: a)
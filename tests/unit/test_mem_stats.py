@@ -0,0 +1,82 @@
+#****************************************************************************
+#* test_mem_stats.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import os
+import tempfile
+import zsp_dataclasses as zdc
+from .test_base import TestBase
+
+class TestMemStats(TestBase):
+
+    def test_model(self):
+
+        @zdc.struct
+        class my_reg1(object):
+            f1 : zdc.uint8_t
+            f2 : zdc.uint8_t
+
+        @zdc.reg_group_c
+        class my_regs(object):
+            r1 : zdc.reg_c[my_reg1] = dict(offset=0x10)
+            r2 : zdc.reg_c[my_reg1] = dict(offset=0x14)
+
+        @zdc.component
+        class pss_top(object):
+            regs : my_regs
+
+            @zdc.action
+            class Entry(object):
+                a : zdc.rand_uint8_t
+
+                @zdc.exec.body
+                def body(self):
+                    self.comp.regs.r1.read()
+
+        top = pss_top()
+        snap = zdc.impl.Ctor.inst().memStats(top)
+        print(snap.report())
+
+        self.assertEqual(snap.stats["component:inst"][pss_top.__qualname__][0], 1)
+        self.assertIn(pss_top.Entry.__qualname__, snap.stats["type:action"].keys())
+        self.assertGreater(snap.stats["type:action"][pss_top.Entry.__qualname__][1], 0)
+        self.assertIn(pss_top.__qualname__, snap.stats["type:component"].keys())
+        self.assertGreater(snap.total("class")[0], 0)
+
+    def test_diff(self):
+        base = zdc.MemSnapshot()
+        base.add("component:inst", "top", 1, 100)
+        base.add("component:inst", "sub", 4, 400)
+
+        cur = zdc.MemSnapshot()
+        cur.add("component:inst", "top", 1, 100)
+        cur.add("component:inst", "sub", 2, 200)
+        cur.add("type:action", "Entry", 1, 64)
+
+        d = cur.diff(base)
+        self.assertNotIn("top", d.stats["component:inst"].keys())
+        self.assertEqual(d.stats["component:inst"]["sub"], [-2, -200])
+        self.assertEqual(d.stats["type:action"]["Entry"], [1, 64])
+        self.assertEqual(d.total(), (-1, -136))
+
+        with tempfile.TemporaryDirectory() as tmpdir:
+            path = os.path.join(tmpdir, "mem.json")
+            cur.save(path)
+            self.assertEqual(zdc.MemSnapshot.load(path).stats, cur.stats)
@@ -0,0 +1,173 @@
+#****************************************************************************
+#* test_model_eval_batch.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+from zsp_dataclasses.impl.context import ModelEvalNodeT
+from zsp_dataclasses.impl.model_eval_batch import ModelEvalBatch, ModelEvalNode
+from .test_base import TestBase
+
+class TestModelEvalBatch(TestBase):
+
+    class CompRef(object):
+        def getRef(self):
+            return self
+
+    class ActionField(object):
+        def __init__(self, data):
+            self.data = data
+        def getField(self, idx):
+            return TestModelEvalBatch.CompRef()
+        def getFieldData(self):
+            return self.data
+
+    class Iterator(object):
+        """Iterates a list of (kind, value) nodes"""
+        def __init__(self, nodes):
+            self.nodes = nodes
+            self.idx = -1
+            self.n_next = 0
+        def next(self):
+            self.n_next += 1
+            self.idx += 1
+            return self.idx < len(self.nodes)
+        def type(self):
+            return self.nodes[self.idx][0]
+        def action(self):
+            return TestModelEvalBatch.ActionField(self.nodes[self.idx][1])
+        def iterator(self):
+            return self.nodes[self.idx][1]
+
+    def test_batch_actions(self):
+        it = TestModelEvalBatch.Iterator(
+            [(ModelEvalNodeT.Action, i) for i in range(10)])
+
+        reader = ModelEvalBatch(it)
+        batch = reader.next(4)
+        self.assertEqual([n.action for n in batch], [0, 1, 2, 3])
+        batch = reader.next(4)
+        self.assertEqual([n.action for n in batch], [4, 5, 6, 7])
+        batch = reader.next(4)
+        self.assertEqual([n.action for n in batch], [8, 9])
+        self.assertTrue(reader.done)
+
+        # The exhausted iterator isn't advanced again
+        self.assertEqual(len(reader.next(4)), 0)
+        self.assertEqual(it.n_next, 11)
+
+    def test_batch_ends_at_parallel(self):
+        branches = object()
+        it = TestModelEvalBatch.Iterator([
+            (ModelEvalNodeT.Action, 0),
+            (ModelEvalNodeT.Parallel, branches),
+            (ModelEvalNodeT.Action, 1)])
+
+        reader = ModelEvalBatch(it)
+        batch = reader.next(8)
+        self.assertEqual(len(batch), 2)
+        self.assertEqual(batch[1].kind, ModelEvalNodeT.Parallel)
+        self.assertIs(batch[1].iterator, branches)
+
+        # The action after the parallel isn't fetched until the
+        # parallel has been dispatched
+        self.assertFalse(reader.done)
+        batch = reader.next(8)
+        self.assertEqual([n.action for n in batch], [1])
+
+    class BatchIterator(Iterator):
+        """Produces whole batches, as a native evaluator does"""
+        def __init__(self, nodes, supported=True):
+            super().__init__(nodes)
+            self.supported = supported
+            self.n_batch = 0
+        def nextBatch(self, max_n):
+            self.n_batch += 1
+            if not self.supported:
+                return None
+            ret = []
+            while len(ret) < max_n and self.idx+1 < len(self.nodes):
+                self.idx += 1
+                kind, val = self.nodes[self.idx]
+                ret.append(ModelEvalNode(kind, None, val, None))
+            return ret
+
+    def test_batch_native(self):
+        it = TestModelEvalBatch.BatchIterator(
+            [(ModelEvalNodeT.Action, i) for i in range(6)])
+
+        reader = ModelEvalBatch(it)
+        self.assertEqual([n.action for n in reader.next(4)], [0, 1, 2, 3])
+        self.assertEqual([n.action for n in reader.next(4)], [4, 5])
+        self.assertEqual(len(reader.next(4)), 0)
+        self.assertTrue(reader.done)
+
+        # Each batch is one call, and next() is never used
+        self.assertEqual(len(reader.next(4)), 0)
+        self.assertEqual(it.n_batch, 3)
+        self.assertEqual(it.n_next, 0)
+
+    def test_batch_native_unsupported(self):
+        it = TestModelEvalBatch.BatchIterator(
+            [(ModelEvalNodeT.Action, i) for i in range(6)],
+            supported=False)
+
+        reader = ModelEvalBatch(it)
+        self.assertEqual([n.action for n in reader.next(4)], [0, 1, 2, 3])
+        self.assertEqual([n.action for n in reader.next(4)], [4, 5])
+
+        # nextBatch is only tried once before stepping node-by-node
+        self.assertEqual(it.n_batch, 1)
+        self.assertEqual(it.n_next, 7)
+
+    def test_node_recycling(self):
+        ModelEvalBatch._node_pool.clear()
+
+        it = TestModelEvalBatch.Iterator(
+            [(ModelEvalNodeT.Action, i) for i in range(8)])
+        reader = ModelEvalBatch(it)
+        batch = reader.next(4)
+        node_ids = set(id(n) for n in batch)
+        ModelEvalBatch.release(batch)
+
+        # Released nodes drop their references
+        self.assertTrue(all(n.action is None for n in batch))
+
+        batch = reader.next(4)
+        self.assertEqual(set(id(n) for n in batch), node_ids)
+        self.assertEqual([n.action for n in batch], [4, 5, 6, 7])
+        self.assertTrue(all(isinstance(n, ModelEvalNode) for n in batch))
+
+    def test_obj_pool(self):
+        from zsp_dataclasses.impl.obj_pool import ObjPool
+
+        reset_l = []
+        pool = ObjPool(
+            lambda v: [v], 
+            lambda o, v: reset_l.append((o, v)),
+            max_free=1)
+        a = pool.acquire(1)
+        b = pool.acquire(2)
+        self.assertIsNone(pool.take(3))
+        pool.release(a)
+        pool.release(b)
+        # Only max_free objects are retained
+        self.assertEqual(len(pool), 1)
+        self.assertIs(pool.acquire(4), a)
+        self.assertEqual(reset_l, [(a, 4)])
+        self.assertEqual((pool.n_created, pool.n_reused), (2, 1))
@@ -0,0 +1,123 @@
+#****************************************************************************
+#* test_profiling.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import json
+import os
+import tempfile
+import zsp_dataclasses as zdc
+from .test_base import TestBase
+
+class TestProfiling(TestBase):
+
+    class A(object):
+        pass
+
+    class B(object):
+        pass
+
+    def _events(self, listener):
+        A, B = TestProfiling.A, TestProfiling.B
+        listener.evalBegin(A, 0.0)
+        listener.solveStep(0.0, 0.5, 4)
+        listener.fork(0.5, 2, 0)
+        listener.branchBegin(0.6, 1)
+        listener.action(A(), 0.6, 1.0, 0.25)
+        listener.branchBegin(0.7, 1)
+        listener.action(B(), 0.7, 0.8, 0.05)
+        listener.action(A(), 1.0, 1.2, 0.1)
+        listener.branchEnd(1.2, 1)
+        listener.branchEnd(1.3, 1)
+        listener.evalEnd(A, 2.0)
+
+    def test_profiler(self):
+        prof = zdc.EvalProfiler()
+        self._events(prof)
+
+        a = prof.action_m[TestProfiling.A.__qualname__]
+        self.assertEqual(a.count, 2)
+        self.assertAlmostEqual(a.wall, 0.6)
+        self.assertAlmostEqual(a.cpu, 0.35)
+        self.assertEqual(prof.action_m[TestProfiling.B.__qualname__].count, 1)
+        self.assertEqual(prof.solve.count, 1)
+        self.assertEqual(prof.fanout.max, 2)
+        self.assertEqual(prof.outstanding.max, 2)
+        self.assertAlmostEqual(prof.t_eval, 2.0)
+
+        # Action types are listed by total time
+        lines = prof.report().splitlines()
+        self.assertTrue(lines[4].startswith(TestProfiling.A.__qualname__))
+
+    def test_chrome_trace(self):
+        exp = zdc.ChromeTraceExporter()
+        exp._t0 = 0.0
+        self._events(exp)
+
+        path = os.path.join(tempfile.mkdtemp(), "trace.json")
+        exp.write(path)
+        with open(path, "r") as fp:
+            trace = json.load(fp)
+
+        ev_l = trace["traceEvents"]
+        actions = list(filter(lambda e: e.get("cat") == "action", ev_l))
+        self.assertEqual(len(actions), 3)
+        self.assertAlmostEqual(actions[0]["ts"], 0.6e6)
+        self.assertAlmostEqual(actions[0]["dur"], 0.4e6)
+        counters = list(filter(lambda e: e["ph"] == "C" and e["name"] == "branches", ev_l))
+        self.assertEqual(counters[-1]["args"], {"queued" : 0, "outstanding" : 0})
+        # One track for the eval, and one for each branch
+        self.assertEqual(len(list(filter(lambda e: e["ph"] == "M", ev_l))), 3)
+
+    def test_chrome_trace_tracks(self):
+        A, B = TestProfiling.A, TestProfiling.B
+        exp = zdc.ChromeTraceExporter()
+        exp._t0 = 0.0
+
+        async def branch(T, t):
+            exp.branchBegin(t, 1)
+            await asyncio.sleep(0)
+            exp.action(T(), t, t+0.5, 0.0)
+            exp.branchEnd(t+1.0, 1)
+
+        async def run(T, t):
+            exp.evalBegin(T, t)
+            # Branches interleave on this thread
+            await asyncio.gather(branch(A, t), branch(B, t))
+            exp.evalEnd(T, t+2.0)
+
+        async def run_all():
+            await asyncio.gather(run(A, 0.0), run(B, 1.0))
+        asyncio.run(run_all())
+
+        ev_l = exp.trace()["traceEvents"]
+        tid_m = dict((e["tid"], e["args"]["name"]) for e in ev_l if e["ph"] == "M")
+        self.assertEqual(len(tid_m), 6)
+
+        # Each action is on the track of the branch that ran it
+        for e in filter(lambda e: e.get("cat") == "action", ev_l):
+            self.assertTrue(tid_m[e["tid"]].startswith("branch"))
+        branch_l = list(filter(lambda e: e.get("cat") == "branch", ev_l))
+        self.assertEqual(len(set(e["tid"] for e in branch_l)), 4)
+
+        # Each eval keeps its own begin time
+        eval_l = list(filter(lambda e: e.get("cat") == "eval", ev_l))
+        self.assertEqual(sorted(e["dur"] for e in eval_l), [2.0e6, 2.0e6])
+        self.assertEqual(len(set(e["tid"] for e in eval_l)), 2)
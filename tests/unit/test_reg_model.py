@@ -82,3 +82,53 @@ class TestRegModel(TestBase):
             pass
         
 
+
+    def test_ref_path(self):
+        from zsp_dataclasses.impl.field_reg_c_impl import FieldRegCImpl
+
+        class MI(object):
+            def __init__(self, name, idx, parent):
+                self._name = name
+                self._idx = idx
+                self._parent = parent
+
+        root = MI("root", -1, None)
+        regs = MI("regs", 2, root)
+        rg1 = MI("rg1", 0, regs)
+
+        self.assertEqual(FieldRegCImpl.refPath(root), ())
+        self.assertEqual(FieldRegCImpl.refPath(rg1), (2, 0))
+
+        f = FieldRegCImpl(rg1, "r2", 1)
+        f.mkRef()
+        self.assertEqual(f._path, (2, 0, 1))
+
+    def test_core_fn_cached(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+
+        ctor = Ctor.inst()
+        lookup_l = []
+        find_f = ctor.ctxt().findDataTypeFunction
+        def find(name):
+            lookup_l.append(name)
+            return find_f(name)
+        ctor._ctxt.findDataTypeFunction = find
+
+        f1 = ctor.core_fn("pss::core::reg_read")
+        f2 = ctor.core_fn("pss::core::reg_read")
+        self.assertIs(f1, f2)
+        self.assertEqual(lookup_l, ["pss::core::reg_read"])
+
+        with self.assertRaises(Exception):
+            ctor.core_fn("pss::core::no_such_fn")
+
+    def test_core_fn_sym(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+
+        ctor = Ctor.inst()
+        sym = Ctor.sym("pss::core::reg_write")
+        self.assertEqual(Ctor.sym("pss::core::reg_write"), sym)
+        self.assertIs(ctor.core_fn(sym), ctor.core_fn("pss::core::reg_write"))
+        self.assertIs(
+            ctor.core_fn(sym), 
+            ctor.ctxt().findDataTypeFunction("pss::core::reg_write"))
@@ -0,0 +1,161 @@
+#****************************************************************************
+#* test_resource_allocator.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+from zsp_dataclasses.impl.resource_allocator import ResourceAllocator
+from .test_base import TestBase
+
+class TestResourceAllocator(TestBase):
+
+    class Claim(object):
+        def __init__(self, target_ti, is_lock):
+            self.target_ti = target_ti
+            self.is_lock = is_lock
+
+    class Field(object):
+        """Stands in for an action's model field, whose claim fields
+        reference resources with the listed instance ids"""
+        def __init__(self, *inst_ids):
+            self._inst_ids = inst_ids
+
+        def getField(self, idx):
+            return self
+
+        def getRef(self):
+            return self
+
+        def val(self):
+            return self
+
+        def val_i(self):
+            return self._inst_ids[0]
+
+    def _run(self, claim_l, n, nap=0.001):
+        alloc = ResourceAllocator()
+        active = {}
+        max_active = {}
+
+        async def action(inst_id, claim):
+            grant = await alloc.acquire(
+                TestResourceAllocator.Field(inst_id), [(1, claim)])
+            key = (claim.is_lock, inst_id)
+            active[key] = active.get(key, 0) + 1
+            max_active[key] = max(max_active.get(key, 0), active[key])
+            await asyncio.sleep(nap)
+            active[key] -= 1
+            alloc.release(grant)
+
+        async def run():
+            await asyncio.gather(*(action(i % 2, c) for c in claim_l for i in range(n)))
+
+        asyncio.run(run())
+        return alloc, max_active
+
+    def test_lock_serializes(self):
+        R = object()
+        alloc, max_active = self._run([TestResourceAllocator.Claim(R, True)], 8)
+        self.assertEqual(max_active[(True, 0)], 1)
+        self.assertEqual(max_active[(True, 1)], 1)
+        pool = alloc.pool(R)
+        self.assertEqual(pool.lock_bits, 0)
+        self.assertGreater(pool.n_wait, 0)
+
+    def test_share_concurrent(self):
+        R = object()
+        alloc, max_active = self._run([TestResourceAllocator.Claim(R, False)], 8)
+        self.assertEqual(max_active[(False, 0)], 4)
+        self.assertEqual(alloc.pool(R).n_wait, 0)
+
+    def test_lock_excludes_share(self):
+        R = object()
+        seen = []
+        alloc = ResourceAllocator()
+        lock = TestResourceAllocator.Claim(R, True)
+        share = TestResourceAllocator.Claim(R, False)
+
+        async def action(claim, tag):
+            grant = await alloc.acquire(
+                TestResourceAllocator.Field(0), [(1, claim)])
+            seen.append(tag)
+            await asyncio.sleep(0.001)
+            seen.append(tag)
+            alloc.release(grant)
+
+        async def run():
+            await asyncio.gather(
+                action(share, "s1"),
+                action(lock, "l"),
+                action(share, "s2"))
+
+        asyncio.run(run())
+        # The waiting lock is not overtaken by the later share
+        self.assertEqual(seen, ["s1", "s1", "l", "l", "s2", "s2"])
+
+    def test_cancel_releases_held_pools(self):
+        R1 = object()
+        R2 = object()
+        alloc = ResourceAllocator()
+        # Pools are acquired in creation order
+        alloc.pool(R1)
+        alloc.pool(R2)
+
+        async def run():
+            held = await alloc.acquire(
+                TestResourceAllocator.Field(0), 
+                [(1, TestResourceAllocator.Claim(R2, True))])
+            task = asyncio.create_task(alloc.acquire(
+                TestResourceAllocator.Field(0), [
+                    (1, TestResourceAllocator.Claim(R1, True)),
+                    (2, TestResourceAllocator.Claim(R2, True))]))
+            await asyncio.sleep(0.001)
+            # The task holds R1, and waits on R2
+            self.assertNotEqual(alloc.pool(R1).lock_bits, 0)
+            task.cancel()
+            with self.assertRaises(asyncio.CancelledError):
+                await task
+            alloc.release(held)
+
+        asyncio.run(run())
+        self.assertEqual(alloc.pool(R1).lock_bits, 0)
+        self.assertEqual(alloc.pool(R2).lock_bits, 0)
+
+    def test_cancel_after_grant(self):
+        R = object()
+        alloc = ResourceAllocator()
+        lock = TestResourceAllocator.Claim(R, True)
+        err_l = []
+
+        async def run():
+            asyncio.get_running_loop().set_exception_handler(
+                lambda loop, ctxt: err_l.append(ctxt))
+            held = await alloc.acquire(TestResourceAllocator.Field(0), [(1, lock)])
+            task = asyncio.create_task(
+                alloc.acquire(TestResourceAllocator.Field(0), [(1, lock)]))
+            await asyncio.sleep(0.001)
+            # The waiter is granted, then cancelled before it wakes
+            alloc.release(held)
+            task.cancel()
+            with self.assertRaises(asyncio.CancelledError):
+                await task
+
+        asyncio.run(run())
+        self.assertEqual(err_l, [])
+        self.assertEqual(alloc.pool(R).lock_bits, 0)
@@ -1,4 +1,7 @@
 
+import shutil
+import tempfile
+import unittest
 from .test_base import TestBase
 import zsp_dataclasses as arl
 
@@ -10,4 +13,238 @@ class TestSmoke(TestBase):
         class MyAction(object):
             pass
 
-        pass
\ No newline at end of file
+        pass
+
+    def test_incremental_elab(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.type_info import TypeInfo
+
+        @arl.component
+        class pss_top(object):
+
+            @arl.action
+            class Entry(object):
+                pass
+
+        Ctor.inst().elab()
+        self.assertTrue(TypeInfo.get(pss_top).is_elab)
+
+        # Library loaded after the first elaboration
+        @arl.component
+        class pss_lib(object):
+
+            @arl.action
+            class Entry(object):
+                pass
+
+        self.assertFalse(TypeInfo.get(pss_lib).is_elab)
+        Ctor.inst().elab()
+        self.assertTrue(TypeInfo.get(pss_lib).is_elab)
+        self.assertIsNotNone(
+            Ctor.inst().ctxt().findDataTypeComponent(pss_lib.__qualname__))
+
+    def test_elab_two_contexts(self):
+        import vsc_dataclasses.impl as vsc_impl
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.pyctxt.context import Context
+
+        @arl.struct
+        class data_s(object):
+            a : arl.uint8_t
+
+        @arl.component
+        class pss_top(object):
+
+            @arl.action
+            class Entry(object):
+                d : data_s
+
+        Ctor.inst().elab()
+        ctxt1 = Ctor.inst().ctxt()
+
+        # A fresh context (eg one per generated fragment) must also 
+        # receive the types elaborated into the first
+        ctxt2 = Context()
+        Ctor.init(ctxt2)
+        vsc_impl.Ctor.init(ctxt2)
+        Ctor.inst().elab()
+
+        comp_t = ctxt2.findDataTypeComponent(pss_top.__qualname__)
+        self.assertIsNotNone(comp_t)
+        self.assertIs(comp_t, ctxt1.findDataTypeComponent(pss_top.__qualname__))
+        self.assertIsNotNone(ctxt2.findDataTypeAction(pss_top.Entry.__qualname__))
+        self.assertIsNotNone(ctxt2.findDataTypeStruct(data_s.__qualname__))
+
+        # Re-elaborating doesn't import again
+        n_comp = len(ctxt2._comp_t_l)
+        Ctor.inst().elab()
+        self.assertEqual(len(ctxt2._comp_t_l), n_comp)
+
+    def test_lazy_components(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.lazy_component_field import LazyComponentField
+        init_l = []
+
+        @arl.component
+        class leaf_c(object):
+            pass
+
+        @arl.component
+        class init_c(object):
+
+            @arl.exec.init_down
+            def init_down(self):
+                init_l.append("init_c")
+
+        @arl.component
+        class pss_top(object):
+            l1 : leaf_c
+            l2 : leaf_c
+            i1 : init_c
+
+        Ctor.inst().elab()
+        init_l.clear()
+
+        Ctor.inst().lazy_comp = True
+        top = pss_top()
+
+        # Subtrees with init execs are created by the init sequence
+        self.assertEqual(init_l, ["init_c"])
+        l1 = object.__getattribute__(top, "l1")
+        self.assertIsInstance(l1, LazyComponentField)
+        self.assertFalse(l1.is_materialized)
+
+        l1.getBackend()
+        self.assertTrue(l1.is_materialized)
+        self.assertFalse(object.__getattribute__(top, "l2").is_materialized)
+
+        # Late facades don't re-run the initialization sequence
+        object.__getattribute__(top, "i1").materialize()
+        self.assertEqual(init_l, ["init_c"])
+
+        # ...and take the sub-field position reserved for them
+        l2_mi = object.__getattribute__(top, "l2").materialize()._modelinfo
+        Ctor.inst().lazy_comp = False
+        top_e = pss_top()
+        self.assertIs(l2_mi._parent, top._modelinfo)
+        self.assertEqual(l2_mi._idx, top_e.l2._modelinfo._idx)
+
+    def test_shared_init(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        init_l = []
+
+        @arl.component
+        class init_c(object):
+
+            @arl.exec.init_down
+            def init_down(self):
+                init_l.append("init_c")
+
+        @arl.component
+        class pss_top(object):
+            i1 : init_c
+            i2 : init_c
+            i3 : init_c
+
+        Ctor.inst().elab()
+        init_l.clear()
+
+        # Instances run the IR captured at elaboration, so the Python
+        # body isn't re-run for each instance
+        Ctor.inst().shared_init = True
+        top = pss_top()
+        self.assertEqual(init_l, [])
+
+    def test_shared_init_fields(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+
+        @arl.component
+        class init_c(object):
+            a : arl.uint16_t
+            b : arl.uint16_t
+
+            @arl.exec.init_down
+            def init_down(self):
+                self.a = 5
+                self.b = self.a + 1
+
+        @arl.component
+        class pss_top(object):
+            i1 : init_c
+            i2 : init_c
+            i3 : init_c
+
+        Ctor.inst().elab()
+        Ctor.inst().shared_init = True
+        top = pss_top()
+
+        # Each instance gets the values assigned by the shared IR
+        for c in (top.i1, top.i2, top.i3):
+            self.assertEqual(int(c.a), 5)
+            self.assertEqual(int(c.b), 6)
+
+    @unittest.skipIf(shutil.which("c++") is None, "No C++ compiler available")
+    def test_compile_execs(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        from zsp_dataclasses.impl.exec_compiler import ExecCompiler
+
+        @arl.component
+        class init_c(object):
+            a : arl.int8_t
+            b : arl.uint8_t
+
+            @arl.exec.init_down
+            def init_down(self):
+                self.a = -3
+                self.b = self.a + 1
+
+        @arl.component
+        class pss_top(object):
+            i1 : init_c
+            i2 : init_c
+
+        Ctor.inst().elab()
+        Ctor.inst().shared_init = True
+        Ctor.inst().compile_execs = True
+
+        with tempfile.TemporaryDirectory() as cache_dir:
+            Ctor.inst()._exec_compiler = ExecCompiler(cache_dir=cache_dir)
+            top = pss_top()
+
+            # The execs ran from the compiled library
+            self.assertEqual(len(Ctor.inst()._exec_compiler._lib_m), 1)
+
+        # Values are converted to the type of each field
+        for c in (top.i1, top.i2):
+            self.assertEqual(int(c.a), -3)
+            self.assertEqual(int(c.b), 254)
+
+    def test_shared_init_import_call(self):
+        from zsp_dataclasses.impl.ctor import Ctor
+        init_l = []
+
+        @arl.import_fn
+        def set_id(id : int):
+            pass
+
+        @arl.component
+        class init_c(object):
+
+            @arl.exec.init_down
+            def init_down(self):
+                init_l.append("init_c")
+                set_id(1)
+
+        @arl.component
+        class pss_top(object):
+            i1 : init_c
+            i2 : init_c
+
+        Ctor.inst().elab()
+        init_l.clear()
+
+        # Construction has no handler for import calls, so the type
+        # falls back to running the Python body for each instance
+        Ctor.inst().shared_init = True
+        top = pss_top()
+        self.assertEqual(init_l, ["init_c", "init_c"])
@@ -0,0 +1,93 @@
+#****************************************************************************
+#* test_snapshot.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import os
+import tempfile
+import zsp_dataclasses as zdc
+from zsp_dataclasses.impl.ctor import Ctor
+from zsp_dataclasses.impl.pyctxt.context import Context
+from .test_base import TestBase
+
+class TestSnapshot(TestBase):
+
+    def test_save_load(self):
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class A(object):
+                a : zdc.rand_uint8_t
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.activity
+                def activity(self):
+                    with zdc.replicate(2):
+                        zdc.do[pss_top.A]
+
+        Ctor.inst().elab()
+        ctxt = Ctor.inst().ctxt()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            path = os.path.join(tmp_dir, "model.snap")
+            ctxt.saveSnapshot(path, key="v1")
+
+            self.assertEqual(Context.loadSnapshot(path, key="v2"), None)
+            ctxt_l = Context.loadSnapshot(path, key="v1")
+
+        self.assertIsNotNone(ctxt_l)
+        self.assertEqual(
+            sorted(ctxt_l._action_t_m.keys()),
+            sorted(ctxt._action_t_m.keys()))
+        self.assertIsNotNone(ctxt_l.findDataTypeComponent(pss_top.__qualname__))
+        self.assertEqual(
+            list(map(lambda f: f.name(), ctxt_l.getDataTypeFunctions())),
+            list(map(lambda f: f.name(), ctxt.getDataTypeFunctions())))
+
+        # Type references resolve within the loaded context
+        for name,t in ctxt_l._action_t_m.items():
+            self.assertEqual(
+                len(t.getFields()),
+                len(ctxt._action_t_m[name].getFields()))
+            self.assertIs(t.getComponentType(), ctxt_l.findDataTypeComponent(
+                t.getComponentType().name()))
+
+    def test_load_invalid(self):
+
+        @zdc.component
+        class pss_top(object):
+            pass
+
+        Ctor.inst().elab()
+        with tempfile.TemporaryDirectory() as tmp_dir:
+            path = os.path.join(tmp_dir, "model.snap")
+            self.assertIsNone(Context.loadSnapshot(path))
+
+            Ctor.inst().ctxt().saveSnapshot(path)
+            with open(path, "rb") as fp:
+                data = fp.read()
+
+            # Empty, truncated, and foreign files are treated as missing
+            for d in (b"", data[:10], data[:20], data[:-8], b"x" * len(data)):
+                with open(path, "wb") as fp:
+                    fp.write(d)
+                self.assertIsNone(Context.loadSnapshot(path))
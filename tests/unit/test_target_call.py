@@ -0,0 +1,116 @@
+#****************************************************************************
+#* test_target_call.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import asyncio
+import zsp_dataclasses as zdc
+from zsp_dataclasses.impl.target_call import TargetCall
+from .test_base import TestBase
+
+class TestTargetCall(TestBase):
+
+    class Xfer(object):
+        data = zdc.buf(16)
+        words = zdc.buf(4, "I")
+
+    def test_buf_field(self):
+        x = TestTargetCall.Xfer()
+        self.assertEqual(len(x.data), 16)
+        self.assertIs(x.data, x.data)
+        self.assertEqual(memoryview(x.words).nbytes, 4*x.words.itemsize)
+
+        view = memoryview(x.data)
+        x.data = bytes(range(16))
+        # Assignment copies into the existing storage
+        self.assertEqual(view[15], 15)
+        with self.assertRaises(Exception):
+            x.data = bytes(4)
+        self.assertIsNot(TestTargetCall.Xfer().data, x.data)
+
+    def test_zero_copy(self):
+        x = TestTargetCall.Xfer()
+        seen = []
+
+        def impl(addr, data):
+            seen.append(data)
+            data[0] = addr
+            return addr + 1
+
+        call = TargetCall("xfer", impl)
+        ret = asyncio.run(call(7, x.data))
+        self.assertEqual(ret, 8)
+        self.assertIsInstance(seen[0], memoryview)
+        self.assertIs(seen[0].obj, x.data)
+        self.assertEqual(x.data[0], 7)
+
+    def test_batched(self):
+        batch_l = []
+
+        async def impl(args_l):
+            batch_l.append(len(args_l))
+            return [a[0]*2 for a in args_l]
+
+        call = TargetCall("xfer", impl, batch_sz=4)
+
+        async def run():
+            return await asyncio.gather(*(call(i) for i in range(10)))
+
+        self.assertEqual(asyncio.run(run()), [i*2 for i in range(10)])
+        self.assertEqual(batch_l, [4, 4, 2])
+        self.assertEqual(call.n_calls, 10)
+        self.assertEqual(call.n_batches, 3)
+
+    def test_batched_exception(self):
+        def impl(args_l):
+            raise Exception("target failed")
+
+        call = TargetCall("xfer", impl, batch_sz=8)
+
+        async def run():
+            return await asyncio.gather(call(1), call(2), return_exceptions=True)
+
+        res = asyncio.run(run())
+        self.assertEqual(len(res), 2)
+        for r in res:
+            self.assertIn("target failed", str(r))
+
+    def test_batched_cancel(self):
+        async def impl(args_l):
+            await asyncio.Event().wait()
+
+        call = TargetCall("xfer", impl, batch_sz=8)
+
+        async def run():
+            f_l = [call(1), call(2)]
+            # Let the batch be flushed and start running
+            await asyncio.sleep(0)
+            await asyncio.sleep(0)
+            self.assertEqual(len(call._task_s), 1)
+            for t in list(call._task_s):
+                t.cancel()
+            res = await asyncio.gather(*f_l, return_exceptions=True)
+            await asyncio.sleep(0)
+            return res
+
+        # Callers of a cancelled batch don't wait forever
+        res = asyncio.run(run())
+        for r in res:
+            self.assertIsInstance(r, asyncio.CancelledError)
+        self.assertEqual(len(call._task_s), 0)
@@ -0,0 +1,133 @@
+#****************************************************************************
+#* test_with_c.py
+#*
+#* Copyright 2022 Matthew Ballance and Contributors
+#*
+#* Licensed under the Apache License, Version 2.0 (the "License"); you may 
+#* not use this file except in compliance with the License.  
+#* You may obtain a copy of the License at:
+#*
+#*   http://www.apache.org/licenses/LICENSE-2.0
+#*
+#* Unless required by applicable law or agreed to in writing, software 
+#* distributed under the License is distributed on an "AS IS" BASIS, 
+#* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.  
+#* See the License for the specific language governing permissions and 
+#* limitations under the License.
+#*
+#* Created on:
+#*     Author: 
+#*
+#****************************************************************************
+import zsp_dataclasses as zdc
+from .test_base import TestBase
+
+class TestWithC(TestBase):
+
+    def test_precompile(self):
+        zdc.impl.Ctor.inst().precompile_with = True
+        closure_l = []
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Sub(object):
+                a : zdc.rand_uint8_t
+                b : zdc.rand_uint8_t
+                c : zdc.rand_uint8_t
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.activity
+                def activity(self):
+                    t = zdc.do[pss_top.Sub]()
+                    closure_l.append(t)
+                    with t as it:
+                        it.a == 4
+                        it.a == 4
+                        it.b > 2
+                        1 <= it.b
+                        it.b < 10
+                        it.b <= 12
+                        it.a < it.c
+
+                    t = zdc.do[pss_top.Sub]()
+                    closure_l.append(t)
+                    with t as it:
+                        it.a == 1
+                        it.a == 2
+
+        zdc.impl.Ctor.inst().elab()
+        self.assertEqual(len(closure_l), 2)
+
+        plan = closure_l[0].plan
+        self.assertEqual(list(plan.assign_m.values()), [4])
+        self.assertEqual(list(plan.domain_m.values()), [(3, 9)])
+        # One equality, the tightest bounds, and the unrecognized term
+        self.assertEqual(plan.keep_l, [0, 2, 4, 6])
+        self.assertEqual(
+            len(closure_l[0].traverse_t.getWithC().getConstraints()), 4)
+
+        # Conflicting terms are left for the solver to report
+        plan = closure_l[1].plan
+        self.assertEqual(len(plan.unsat_l), 1)
+        self.assertEqual(plan.keep_l, [0, 1])
+
+    def test_precompile_unsigned_max(self):
+        zdc.impl.Ctor.inst().precompile_with = True
+        closure_l = []
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Sub(object):
+                a : zdc.rand_uint64_t
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.activity
+                def activity(self):
+                    t = zdc.do[pss_top.Sub]()
+                    closure_l.append(t)
+                    with t as it:
+                        it.a < 0xFFFFFFFFFFFFFFFF
+                        it.a < 10
+
+        zdc.impl.Ctor.inst().elab()
+
+        # The large constant must not read as a tighter (negative) bound
+        plan = closure_l[0].plan
+        self.assertIn(1, plan.keep_l)
+        self.assertEqual(list(plan.domain_m.values()), [(None, 9)])
+
+    def test_precompile_default_off(self):
+        closure_l = []
+
+        @zdc.component
+        class pss_top(object):
+
+            @zdc.action
+            class Sub(object):
+                a : zdc.rand_uint8_t
+
+            @zdc.action
+            class Entry(object):
+
+                @zdc.activity
+                def activity(self):
+                    t = zdc.do[pss_top.Sub]()
+                    closure_l.append(t)
+                    with t as it:
+                        it.a == 4
+                        it.a == 4
+
+        zdc.impl.Ctor.inst().elab()
+
+        # Every term reaches the solver
+        self.assertIsNone(closure_l[0].plan)
+        self.assertEqual(
+            len(closure_l[0].traverse_t.getWithC().getConstraints()), 2)